@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport
 
@@ -31,7 +31,28 @@ SOURCES += \
     newfile.cpp \
     aboutwindow.cpp \
     mycheckbox.cpp \
-    helpwindow.cpp
+    helpwindow.cpp \
+    paretofront.cpp \
+    frontmetrics.cpp \
+    hypervolume.cpp \
+    hvestimator.cpp \
+    designstore.cpp \
+    metriccache.cpp \
+    anytimecurves.cpp \
+    datatreeitem.cpp \
+    bootstrap.cpp \
+    metrictask.cpp \
+    densitymap.cpp \
+    pointindex.cpp \
+    pointpyramid.cpp \
+    groupscatter.cpp \
+    groupfronts.cpp \
+    grouplegenditem.cpp \
+    pointraster.cpp \
+    batchreport.cpp \
+    scattermatrix.cpp \
+    parallelcoords.cpp \
+    dataplot.cpp
 
 HEADERS += \
         mainwindow.h \
@@ -39,7 +60,29 @@ HEADERS += \
     newfile.h \
     aboutwindow.h \
     mycheckbox.h \
-    helpwindow.h
+    helpwindow.h \
+    paretofront.h \
+    frontmetrics.h \
+    hypervolume.h \
+    hvestimator.h \
+    designstore.h \
+    metriccache.h \
+    anytimecurves.h \
+    datatreeitem.h \
+    bootstrap.h \
+    metrictask.h \
+    densitymap.h \
+    pointindex.h \
+    pointpyramid.h \
+    groupscatter.h \
+    groupfronts.h \
+    grouplegenditem.h \
+    pointraster.h \
+    batchreport.h \
+    scattermatrix.h \
+    parallelcoords.h \
+    random.h \
+    dataplot.h
 
 FORMS += \
         mainwindow.ui \
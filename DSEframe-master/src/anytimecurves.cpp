@@ -0,0 +1,258 @@
+#include "anytimecurves.h"
+#include "paretofront.h"
+#include "frontmetrics.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+namespace {
+
+struct CurveTask
+{
+    AnytimeCurve *curve;
+    const QVector< QPointF > *new_rows;
+    const QAtomicInt *cancelled;
+};
+
+void runCurveTask(CurveTask &task)
+{
+    if (task.cancelled->loadAcquire()) return;
+
+    task.curve->extend(*task.new_rows);
+}
+
+bool lessX(const QPointF &a, double x)
+{
+    return a.x() < x;
+}
+
+}
+
+QString AnytimeCurves::metricName(int metric)
+{
+    switch (metric) {
+    case ADRS:        return "ADRS";
+    case HyperVolume: return "HyperVolume";
+    case Dominance:   return "Dominance";
+    default:          return "";
+    }
+}
+
+/*
+ *     Reference front with the norm of each point, by which ADRS divides
+ *     the distances measured to it
+ */
+AnytimeCurves::Reference AnytimeCurves::makeReference(const QVector< QPointF > &front, const QPointF &hv_reference, double hypervolume)
+{
+    Reference reference;
+    reference.front = front;
+    reference.norms.resize(front.size());
+    for (int i = 0; i < front.size(); i++) {
+        reference.norms[i] = sqrt(front[i].x() * front[i].x() + front[i].y() * front[i].y());
+    }
+    reference.hv_reference = hv_reference;
+    reference.hypervolume = hypervolume;
+    return reference;
+}
+
+/*
+ *     Whether curves made against one reference hold for the other: the
+ *     same front, reference point and hypervolume, compared exactly
+ */
+bool AnytimeCurves::sameReference(const Reference &a, const Reference &b)
+{
+    if ((a.front.size() != b.front.size()) || (a.hv_reference.x() != b.hv_reference.x()) ||
+        (a.hv_reference.y() != b.hv_reference.y()) || (a.hypervolume != b.hypervolume)) {
+        return false;
+    }
+
+    for (int i = 0; i < a.front.size(); i++) {
+        if ((a.front[i].x() != b.front[i].x()) || (a.front[i].y() != b.front[i].y())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ *     Extend the curve of every method with its new rows concurrently,
+ *     one task per method with rows
+ */
+QVector< AnytimeCurve > AnytimeCurves::run(QVector< AnytimeCurve > curves, QVector< QVector< QPointF > > new_rows, MetricTask::CancelToken cancelled)
+{
+    QVector< CurveTask > tasks;
+    for (int i = 0; (i < curves.size()) && (i < new_rows.size()); i++) {
+        if (!new_rows[i].isEmpty()) {
+            CurveTask task;
+            task.curve = &curves[i];
+            task.new_rows = &new_rows[i];
+            task.cancelled = cancelled.data();
+            tasks.append(task);
+        }
+    }
+    QtConcurrent::blockingMap(tasks, runCurveTask);
+
+    return curves;
+}
+
+AnytimeCurve::AnytimeCurve()
+{
+    reset(AnytimeCurves::Reference(), 1);
+}
+
+void AnytimeCurve::reset(const AnytimeCurves::Reference &reference, int stride)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+
+    this->reference = reference;
+    this->stride = qMax(stride, 1);
+    row_cnt = 0;
+    samples.evaluations.clear();
+    samples.values.fill(QVector< double >(), AnytimeCurves::MetricCount);
+
+    front.clear();
+    hypervolume.reset(reference.hv_reference);
+    owned_cnt = 0;
+    front_terms.clear();
+    front_sum = 0.0;
+
+    // No front point yet: every reference point is infinitely far away
+    const int reference_cnt = reference.front.size();
+    nearest.fill(QPointF(inf, inf), reference_cnt);
+    nearest_distance2.fill(inf, reference_cnt);
+    nearest_terms.fill(0.0, reference_cnt);
+    reference_sum = 0.0;
+}
+
+/*
+ *     Replay the rows appended after the ones seen so far and sample the
+ *     metrics
+ *
+ *     The sample that closed the previous extend is dropped unless it fell
+ *     on the stride, as the last row is now a later one.
+ */
+void AnytimeCurve::extend(const QVector< QPointF > &new_rows)
+{
+    if (new_rows.isEmpty()) {
+        return;
+    }
+
+    if (!samples.evaluations.isEmpty() && (row_cnt % stride != 0)) {
+        samples.evaluations.removeLast();
+        for (int m = 0; m < AnytimeCurves::MetricCount; m++) {
+            samples.values[m].removeLast();
+        }
+    }
+
+    const int row_last = row_cnt + new_rows.size();
+    for (int k = 0; k < new_rows.size(); k++) {
+        insertRow(new_rows[k]);
+        row_cnt++;
+
+        if ((row_cnt % stride == 0) || (row_cnt == row_last)) {
+            samples.evaluations.append(row_cnt);
+            sample();
+        }
+    }
+}
+
+/*
+ *     Insert a row into the front and update the metric terms it touches
+ *
+ *     The points a row evicts are those it weakly dominates: they follow
+ *     its x position for as long as their y is not below its y.
+ */
+void AnytimeCurve::insertRow(const QPointF &row)
+{
+    const int first = std::lower_bound(front.constBegin(), front.constEnd(), row.x(), lessX) - front.constBegin();
+    int last = first;
+    int evicted_owned = 0;
+    double evicted_sum = 0.0;
+    for (; (last < front.size()) && (front[last].y() >= row.y()); last++) {
+        evicted_owned += onReference(front[last]) ? 1 : 0;
+        evicted_sum += front_terms[last];
+    }
+
+    int index;
+    int evicted;
+    if (!ParetoFront::insertPoint(front, row, &index, &evicted)) {
+        return;
+    }
+    Q_ASSERT((index == first) && (evicted == last - first));
+
+    hypervolume.insert(row);
+    owned_cnt += (onReference(row) ? 1 : 0) - evicted_owned;
+
+    const double term = frontTerm(row);
+    front_terms.insert(index, term);
+    front_terms.remove(index + 1, evicted);
+    front_sum += term - evicted_sum;
+
+    for (int i = 0; i < reference.front.size(); i++) {
+        const QPointF &point = reference.front[i];
+        if ((nearest[i].x() >= row.x()) && (nearest[i].y() >= row.y())) {
+            // the nearest point was evicted, or there was none
+            double distance2;
+            const int mark = FrontMetrics::nearestPoint(front, point, &distance2);
+            setNearest(i, (mark >= 0) ? front[mark] : nearest[i], distance2);
+        }
+        else {
+            const double dx = row.x() - point.x();
+            const double dy = row.y() - point.y();
+            const double distance2 = dx * dx + dy * dy;
+            if (distance2 < nearest_distance2[i]) {
+                setNearest(i, row, distance2);
+            }
+        }
+    }
+}
+
+/*
+ *     Whether exactly this value is on the reference front, looked up by x
+ */
+bool AnytimeCurve::onReference(const QPointF &point) const
+{
+    const QVector< QPointF > &points = reference.front;
+    const int k = std::lower_bound(points.constBegin(), points.constEnd(), point.x(), lessX) - points.constBegin();
+    return (k < points.size()) && (points[k].x() == point.x()) && (points[k].y() == point.y());
+}
+
+/*
+ *     Normalized distance from a front point to the nearest reference point
+ */
+double AnytimeCurve::frontTerm(const QPointF &point) const
+{
+    double distance2;
+    const int mark = FrontMetrics::nearestPoint(reference.front, point, &distance2);
+    return (mark >= 0) ? sqrt(distance2) / reference.norms[mark] : 0.0;
+}
+
+void AnytimeCurve::setNearest(int i, const QPointF &point, double distance2)
+{
+    const double term = sqrt(distance2) / reference.norms[i];
+    reference_sum += term - nearest_terms[i];
+    nearest[i] = point;
+    nearest_distance2[i] = distance2;
+    nearest_terms[i] = term;
+}
+
+/*
+ *     Append the metrics of the current front, FrontMetrics::adrs and
+ *     FrontMetrics::dominance read from the kept terms
+ */
+void AnytimeCurve::sample()
+{
+    const int reference_cnt = reference.front.size();
+
+    double adrs = 0.0;
+    if (!front.isEmpty() && (reference_cnt > 0)) {
+        adrs = (front_sum / front.size() + reference_sum / reference_cnt) / 2;
+    }
+
+    samples.values[AnytimeCurves::ADRS].append(adrs);
+    samples.values[AnytimeCurves::HyperVolume].append((reference.hypervolume > 0.0) ? hypervolume.value() / reference.hypervolume : 0.0);
+    samples.values[AnytimeCurves::Dominance].append((reference_cnt > 0) ? (double)owned_cnt / reference_cnt : 0.0);
+}
@@ -0,0 +1,108 @@
+#ifndef ANYTIMECURVES_H
+#define ANYTIMECURVES_H
+
+#include <QVector>
+#include <QPointF>
+#include <QString>
+
+#include "hypervolume.h"
+#include "metrictask.h"
+
+class AnytimeCurve;
+
+/*
+ *     Anytime performance of a method: its metrics after each of the first
+ *     k evaluated designs, against a fixed reference front
+ *
+ *     A sample is taken every `stride` rows plus at the last row. The
+ *     reference front is prepared once and shared by the curves of all
+ *     methods. run() extends copies of the curves on the thread pool, one
+ *     method per thread; once the token is set, methods that have not
+ *     started are skipped.
+ */
+namespace AnytimeCurves {
+
+enum Metric {
+    ADRS,
+    HyperVolume,
+    Dominance,
+    MetricCount
+};
+
+QString metricName(int metric);
+
+struct Curve
+{
+    QVector< double > evaluations;
+    QVector< QVector< double > > values;
+};
+
+struct Reference
+{
+    QVector< QPointF > front;
+    QVector< double > norms;
+    QPointF hv_reference;
+    double hypervolume;
+};
+
+Reference makeReference(const QVector< QPointF > &front, const QPointF &hv_reference, double hypervolume);
+
+bool sameReference(const Reference &a, const Reference &b);
+
+QVector< AnytimeCurve > run(QVector< AnytimeCurve > curves, QVector< QVector< QPointF > > new_rows, MetricTask::CancelToken cancelled);
+
+}
+
+/*
+ *     Anytime curve of one method that grows with its rows
+ *
+ *     The rows are replayed once through an incremental front and
+ *     hypervolume; rows appended later are passed on their own and
+ *     continue from the last one.
+ *     ADRS and dominance are kept up to date point by point: an insert
+ *     adds the terms of the new point and drops those of the points it
+ *     evicts, and every reference point caches its nearest front point,
+ *     which is only searched again when that point is evicted.
+ */
+class AnytimeCurve
+{
+public:
+    AnytimeCurve();
+
+    void reset(const AnytimeCurves::Reference &reference, int stride);
+
+    void extend(const QVector< QPointF > &new_rows);
+
+    int rowCount() const { return row_cnt; }
+
+    const AnytimeCurves::Curve &curve() const { return samples; }
+
+private:
+    void insertRow(const QPointF &row);
+
+    bool onReference(const QPointF &point) const;
+
+    double frontTerm(const QPointF &point) const;
+
+    void setNearest(int i, const QPointF &point, double distance2);
+
+    void sample();
+
+    AnytimeCurves::Reference reference;
+    int stride;
+    int row_cnt;
+    AnytimeCurves::Curve samples;
+
+    QVector< QPointF > front;
+    IncrementalHypervolume hypervolume;
+    int owned_cnt;
+    QVector< double > front_terms;
+    double front_sum;
+
+    QVector< QPointF > nearest;
+    QVector< double > nearest_distance2;
+    QVector< double > nearest_terms;
+    double reference_sum;
+};
+
+#endif // ANYTIMECURVES_H
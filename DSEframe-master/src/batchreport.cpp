@@ -0,0 +1,345 @@
+#include "batchreport.h"
+#include "mainwindow.h"
+
+#include <QCommandLineParser>
+#include <QtConcurrent>
+
+#include <string.h>
+
+namespace {
+
+struct Table
+{
+    QString file_name;
+    DesignStore designs;
+    QStringList group_names;
+    int skipped_rows;
+    QString error;
+};
+
+struct ChartTask
+{
+    const Table *table;
+    QString x_var;
+    QString y_var;
+    QString output_file;
+    QVector< QVector< QPointF > > points;
+    QVector< QVector< QPointF > > fronts;
+    QPointF max;
+    QString error;
+};
+
+/*
+ *     Read a CSV file the way the main window does: a header line, then
+ *     rows grouped by Method/Iteration; rows of the wrong width are skipped
+ *     instead of asking what to do
+ */
+Table loadTable(const QString &file_name)
+{
+    Table table;
+    table.file_name = file_name;
+    table.skipped_rows = 0;
+
+    QFile file(file_name);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        table.error = QObject::tr("cannot open file");
+        return table;
+    }
+
+    QTextStream in(&file);
+    QString method_history;
+    QString iteration_history;
+    int method_index = -1;
+    int iteration_index = -1;
+    int group = -1;
+
+    while (!in.atEnd()) {
+        const QStringList list = in.readLine().split(",", QString::SkipEmptyParts);
+
+        if (table.designs.columnCount() == 0) {
+            table.designs.setHeader(list);
+            method_index = list.indexOf(QObject::tr("Method"));
+            iteration_index = list.indexOf(QObject::tr("Iteration"));
+            if ((method_index == -1) || (iteration_index == -1)) {
+                table.error = QObject::tr("cannot find the Method and Iteration columns");
+                return table;
+            }
+            continue;
+        }
+
+        if (list.size() != table.designs.columnCount()) {
+            table.skipped_rows++;
+            continue;
+        }
+
+        if ((group < 0) || (list.at(method_index) != method_history) || (list.at(iteration_index) != iteration_history)) {
+            group++;
+            method_history = list.at(method_index);
+            iteration_history = list.at(iteration_index);
+            table.group_names.append(method_history + " " + iteration_history);
+        }
+        table.designs.appendRow(group, list);
+    }
+
+    if (table.designs.columnCount() == 0) {
+        table.error = QObject::tr("file is empty");
+    }
+    return table;
+}
+
+/*
+ *     Points and front of every group on the axes of one chart
+ */
+void runChartTask(ChartTask &task)
+{
+    const DesignStore &designs = task.table->designs;
+    if (!task.table->error.isEmpty()) {
+        task.error = task.table->error;
+        return;
+    }
+
+    const int x_column = designs.columnIndex(task.x_var);
+    const int y_column = designs.columnIndex(task.y_var);
+    if ((x_column == -1) || (y_column == -1)) {
+        task.error = QObject::tr("cannot find the columns %1 and %2").arg(task.x_var, task.y_var);
+        return;
+    }
+
+    task.points.resize(designs.groupCount());
+    task.fronts.resize(designs.groupCount());
+    task.max = QPointF(0.0, 0.0);
+    for (int g = 0; g < designs.groupCount(); g++) {
+        for (int row = designs.groupBegin(g); row < designs.groupEnd(g); row++) {
+            const QPointF point = designs.plotPoint(row, x_column, y_column);
+            task.points[g].append(point);
+            task.max.setX(qMax(task.max.x(), point.x()));
+            task.max.setY(qMax(task.max.y(), point.y()));
+        }
+        task.fronts[g] = ParetoFront::build(task.points[g]);
+    }
+}
+
+/*
+ *     Draw one chart on the plot and save it; rows are drawn faded under
+ *     the fronts, like the design space view shows them
+ */
+bool renderChart(QCustomPlot *plot, QCPTextElement *title, GroupLegendItem *legend, const ChartTask &task,
+                 int width, int height, bool pdf)
+{
+    plot->clearPlottables();
+
+    const int group_cnt = task.points.size();
+    QVector< QColor > colors(group_cnt);
+    QVector< QColor > row_colors(group_cnt);
+    QVector< int > groups(group_cnt);
+    QVector< int > row_end(group_cnt);
+    for (int g = 0; g < group_cnt; g++) {
+        colors[g] = MainWindow::methodColor(g);
+        row_colors[g] = colors[g];
+        row_colors[g].setAlpha(80);
+        groups[g] = g;
+        row_end[g] = task.points[g].size();
+    }
+
+    GroupScatter *rows = new GroupScatter(plot->xAxis, plot->yAxis);
+    rows->setName("Rows");
+    rows->setPointSets(&task.points);
+    rows->setPalette(row_colors);
+    rows->setGroupsVisible(QVector< bool >(group_cnt, true));
+    rows->setRows(QVector< int >(group_cnt, 0), row_end);
+    rows->removeFromLegend();
+
+    GroupFronts *fronts = new GroupFronts(plot->xAxis, plot->yAxis);
+    fronts->setName("Fronts");
+    fronts->setFronts(&task.fronts);
+    fronts->setPalette(colors);
+    fronts->setGroupsVisible(QVector< bool >(group_cnt, true));
+    fronts->removeFromLegend();
+
+    legend->setGroups(groups, task.table->group_names, colors);
+    title->setText(QFileInfo(task.table->file_name).fileName());
+    plot->xAxis->setLabel(task.x_var);
+    plot->yAxis->setLabel(task.y_var);
+    plot->xAxis->setRange(0, task.max.x() * 1.1);
+    plot->yAxis->setRange(0, task.max.y() * 1.1);
+
+    return pdf ? plot->savePdf(task.output_file, width, height) : plot->savePng(task.output_file, width, height);
+}
+
+QString fileNamePart(const QString &text)
+{
+    return QString(text).replace(QRegularExpression("[^\\w.-]"), "_");
+}
+
+/*
+ *     Run the report once per shard in child processes and wait for all
+ */
+int runShards(const QStringList &arguments, int shard_cnt)
+{
+    QVector< QProcess *> processes;
+    for (int k = 0; k < shard_cnt; k++) {
+        QProcess *process = new QProcess();
+        process->setProcessChannelMode(QProcess::ForwardedChannels);
+        process->start(QCoreApplication::applicationFilePath(),
+                       arguments.mid(1) << "--shard" << QString("%1/%2").arg(k).arg(shard_cnt));
+        processes.append(process);
+    }
+
+    // A process that could not start reports a normal exit with code 0
+    int failed = 0;
+    QTextStream err(stderr);
+    for (int k = 0; k < processes.size(); k++) {
+        if (!processes[k]->waitForStarted(-1)) {
+            err << QObject::tr("Cannot start %1: %2").arg(processes[k]->program(), processes[k]->errorString()) << endl;
+            failed++;
+        }
+        else {
+            processes[k]->waitForFinished(-1);
+            if ((processes[k]->error() == QProcess::Crashed) || (processes[k]->exitStatus() != QProcess::NormalExit) || (processes[k]->exitCode() != 0)) {
+                failed++;
+            }
+        }
+        delete processes[k];
+    }
+    return (failed > 0) ? 1 : 0;
+}
+
+}
+
+/*
+ *     True if the command line asks for a report; checked before the
+ *     application object exists, so the platform can still be chosen
+ */
+bool BatchReport::requested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--report") == 0) || (strncmp(argv[i], "--report=", 9) == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int BatchReport::run(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("Render the fronts of DSE result files without a window."));
+    parser.addHelpOption();
+    QCommandLineOption report_option("report", QObject::tr("Write the charts to <directory>."), "directory");
+    QCommandLineOption axes_option("axes", QObject::tr("Comma separated x:y column pairs, one chart each."), "pairs", "Latency:AREA");
+    QCommandLineOption format_option("format", QObject::tr("Chart format, png or pdf."), "format", "png");
+    QCommandLineOption size_option("size", QObject::tr("Chart size in pixels."), "WxH", "800x600");
+    QCommandLineOption jobs_option("jobs", QObject::tr("Number of rendering processes."), "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption shard_option("shard", QObject::tr("Render only charts k, k + n, k + 2n, ..."), "k/n");
+    parser.addOption(report_option);
+    parser.addOption(axes_option);
+    parser.addOption(format_option);
+    parser.addOption(size_option);
+    parser.addOption(jobs_option);
+    parser.addOption(shard_option);
+    parser.addPositionalArgument("files", QObject::tr("DSE result files in CSV format."), "files...");
+    parser.process(arguments);
+
+    QTextStream err(stderr);
+    const QStringList files = parser.positionalArguments();
+    const QStringList size = parser.value(size_option).split('x');
+    const int width = size.value(0).toInt();
+    const int height = size.value(1).toInt();
+    const QString format = parser.value(format_option).toLower();
+    if (files.isEmpty() || (width <= 0) || (height <= 0) || ((format != "png") && (format != "pdf"))) {
+        err << parser.helpText();
+        return 1;
+    }
+
+    QStringList x_vars;
+    QStringList y_vars;
+    const QStringList pairs = parser.value(axes_option).split(',', QString::SkipEmptyParts);
+    for (int i = 0; i < pairs.size(); i++) {
+        const QStringList vars = pairs[i].split(':');
+        if (vars.size() != 2) {
+            err << QObject::tr("Bad axis pair: %1").arg(pairs[i]) << endl;
+            return 1;
+        }
+        x_vars.append(vars[0].trimmed());
+        y_vars.append(vars[1].trimmed());
+    }
+
+    if (x_vars.isEmpty()) {
+        err << parser.helpText();
+        return 1;
+    }
+
+    const int chart_cnt = files.size() * x_vars.size();
+    const int jobs = qMin(parser.value(jobs_option).toInt(), chart_cnt);
+    if (!parser.isSet(shard_option) && (jobs > 1)) {
+        return runShards(arguments, jobs);
+    }
+
+    int shard = 0;
+    int shard_cnt = 1;
+    if (parser.isSet(shard_option)) {
+        const QStringList parts = parser.value(shard_option).split('/');
+        shard = parts.value(0).toInt();
+        shard_cnt = qMax(parts.value(1).toInt(), 1);
+    }
+
+    // Files of this shard's charts, loaded concurrently
+    const QDir directory(parser.value(report_option));
+    if (!directory.mkpath(".")) {
+        err << QObject::tr("Cannot create %1").arg(directory.path()) << endl;
+        return 1;
+    }
+    QList< int > chart_files;
+    QStringList shard_files;
+    for (int c = shard; c < chart_cnt; c += shard_cnt) {
+        chart_files.append(c / x_vars.size());
+        if (!shard_files.contains(files[c / x_vars.size()])) {
+            shard_files.append(files[c / x_vars.size()]);
+        }
+    }
+    const QVector< Table > tables = QtConcurrent::blockingMapped< QVector< Table > >(shard_files, loadTable);
+    for (int t = 0; t < tables.size(); t++) {
+        if (tables[t].skipped_rows > 0) {
+            err << tables[t].file_name << ": " << QObject::tr("%1 rows do not match the format and were skipped").arg(tables[t].skipped_rows) << endl;
+        }
+    }
+
+    // Output names start with the file's position, padded so they sort
+    const int index_width = QString::number(files.size()).size();
+    QVector< ChartTask > tasks;
+    for (int c = shard, i = 0; c < chart_cnt; c += shard_cnt, i++) {
+        const QString &file_name = files[chart_files[i]];
+        ChartTask task;
+        task.table = &tables[shard_files.indexOf(file_name)];
+        task.x_var = x_vars[c % x_vars.size()];
+        task.y_var = y_vars[c % x_vars.size()];
+        task.output_file = directory.filePath(QString("%1_%2_%3_%4.%5").arg(chart_files[i] + 1, index_width, 10, QChar('0'))
+                                              .arg(fileNamePart(QFileInfo(file_name).completeBaseName()),
+                                                   fileNamePart(task.x_var), fileNamePart(task.y_var), format));
+        tasks.append(task);
+    }
+    QtConcurrent::blockingMap(tasks, runChartTask);
+
+    // Charts are drawn one after the other by this thread, which owns the plot
+    QCustomPlot plot;
+    QCPTextElement *title = new QCPTextElement(&plot);
+    plot.plotLayout()->insertRow(0);
+    plot.plotLayout()->addElement(0, 0, title);
+    GroupLegendItem *legend = new GroupLegendItem(plot.legend);
+    plot.legend->addItem(legend);
+    plot.legend->setVisible(true);
+
+    int failed = 0;
+    for (int i = 0; i < tasks.size(); i++) {
+        if (tasks[i].error.isEmpty() && !renderChart(&plot, title, legend, tasks[i], width, height, format == "pdf")) {
+            tasks[i].error = QObject::tr("cannot write %1").arg(tasks[i].output_file);
+        }
+
+        if (!tasks[i].error.isEmpty()) {
+            err << tasks[i].table->file_name << ": " << tasks[i].error << endl;
+            failed++;
+        }
+    }
+
+    return (failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+#ifndef BATCHREPORT_H
+#define BATCHREPORT_H
+
+#include <QStringList>
+
+/*
+ *     Front plots of CSV files rendered to PNG or PDF without a window
+ *
+ *     "DSEframe --report <directory> --axes x:y[,x:y...] files..." writes
+ *     one chart per file and axis pair, named <n>_<file>_<x>_<y>.png
+ *     after the file's position n on the command line, which keeps files
+ *     of the same name in different directories apart. The charts are
+ *     shared out over several processes of the application, each loading
+ *     its files and building its fronts on the thread pool, since a plot
+ *     widget can only be drawn by the thread that owns it.
+ */
+namespace BatchReport {
+
+bool requested(int argc, char *argv[]);
+
+int run(const QStringList &arguments);
+
+}
+
+#endif // BATCHREPORT_H
@@ -0,0 +1,99 @@
+#include "bootstrap.h"
+#include "random.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const int chunk_resamples = 256;
+
+struct Chunk
+{
+    const QVector< double > *values;
+    double *means;
+    int resample_cnt;
+    quint64 seed;
+};
+
+void runChunk(Chunk &chunk)
+{
+    const QVector< double > &values = *chunk.values;
+    const quint64 n = values.size();
+
+    quint64 state = chunk.seed;
+    for (int r = 0; r < chunk.resample_cnt; r++) {
+        double sum = 0.0;
+        for (quint64 i = 0; i < n; i++) {
+            sum += values[Random::splitMix64(state) % n];
+        }
+        chunk.means[r] = sum / n;
+    }
+}
+
+/*
+ *     Linearly interpolated quantile of sorted values
+ */
+double quantile(const QVector< double > &sorted, double q)
+{
+    const double position = q * (sorted.size() - 1);
+    const int i = qBound(0, int(position), sorted.size() - 1);
+    const int j = qMin(i + 1, sorted.size() - 1);
+    return sorted[i] + (position - i) * (sorted[j] - sorted[i]);
+}
+
+}
+
+Bootstrap::Summary Bootstrap::summarize(const QVector< double > &values, int resamples, double confidence, quint64 seed)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Summary summary = { values.size(), nan, nan, nan, nan };
+    if (values.isEmpty()) {
+        return summary;
+    }
+
+    QVector< double > sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (int i = 0; i < sorted.size(); i++) {
+        sum += sorted[i];
+    }
+    summary.mean = sum / sorted.size();
+    summary.median = quantile(sorted, 0.5);
+
+    resamples = qMax(resamples, 1);
+    QVector< double > means(resamples);
+    QVector< Chunk > chunks((resamples + chunk_resamples - 1) / chunk_resamples);
+    for (int c = 0; c < chunks.size(); c++) {
+        quint64 state = seed ^ (0xD1B54A32D192ED03ULL * quint64(c + 1));
+        chunks[c].values = &values;
+        chunks[c].means = means.data() + c * chunk_resamples;
+        chunks[c].resample_cnt = qMin(chunk_resamples, resamples - c * chunk_resamples);
+        chunks[c].seed = Random::splitMix64(state);
+    }
+    QtConcurrent::blockingMap(chunks, runChunk);
+
+    std::sort(means.begin(), means.end());
+    summary.lower = quantile(means, (1.0 - confidence) / 2.0);
+    summary.upper = quantile(means, (1.0 + confidence) / 2.0);
+
+    return summary;
+}
+
+/*
+ *     Summaries of several value sets in turn, each drawing its resamples
+ *     on the thread pool
+ */
+QVector< Bootstrap::Summary > Bootstrap::summarizeAll(QVector< QVector< double > > value_sets, int resamples, double confidence, quint64 seed,
+                                                      MetricTask::CancelToken cancelled)
+{
+    QVector< Summary > summaries;
+    for (int i = 0; (i < value_sets.size()) && !cancelled->loadAcquire(); i++) {
+        summaries.append(summarize(value_sets[i], resamples, confidence, seed));
+    }
+
+    return summaries;
+}
@@ -0,0 +1,38 @@
+#ifndef BOOTSTRAP_H
+#define BOOTSTRAP_H
+
+#include <QVector>
+#include <QtGlobal>
+
+#include "metrictask.h"
+
+/*
+ *     Bootstrap statistics of a metric over the iterations of a method
+ *
+ *     The confidence interval is the percentile interval of the mean over
+ *     `resamples` resamples with replacement. Resamples are drawn in chunks
+ *     on the global thread pool, each chunk from its own seed, so the result
+ *     only depends on the seed and not on the number of threads.
+ *     summarizeAll() is meant to be run off the GUI thread; once the token
+ *     is set it stops before the next value set and returns fewer
+ *     summaries.
+ */
+namespace Bootstrap {
+
+struct Summary
+{
+    int count;
+    double mean;
+    double median;
+    double lower;
+    double upper;
+};
+
+Summary summarize(const QVector< double > &values, int resamples = 2000, double confidence = 0.95, quint64 seed = 1);
+
+QVector< Summary > summarizeAll(QVector< QVector< double > > value_sets, int resamples, double confidence, quint64 seed,
+                                MetricTask::CancelToken cancelled);
+
+}
+
+#endif // BOOTSTRAP_H
@@ -0,0 +1,17 @@
+#include "dataplot.h"
+
+DataPlot::DataPlot(QWidget *parent)
+    : QCustomPlot(parent)
+{
+
+}
+
+DataPlot::~DataPlot()
+{
+
+}
+
+bool DataPlot::buffersInvalidated()
+{
+    return hasInvalidatedPaintBuffers();
+}
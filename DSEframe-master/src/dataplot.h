@@ -0,0 +1,24 @@
+#ifndef DATAPLOT_H
+#define DATAPLOT_H
+
+#include "qcustomplot.h"
+
+/*
+ *     Plot of the design space
+ *
+ *     QCPLayer::replot does nothing while the paint buffers wait for a
+ *     full replot, and QCustomPlot only tells its subclasses; streaming
+ *     asks before repainting single layers.
+ */
+class DataPlot : public QCustomPlot
+{
+    Q_OBJECT
+
+public:
+    explicit DataPlot(QWidget *parent = Q_NULLPTR);
+    ~DataPlot();
+
+    bool buffersInvalidated();
+};
+
+#endif // DATAPLOT_H
@@ -0,0 +1,30 @@
+#include "datatreeitem.h"
+
+DataTreeItem::DataTreeItem(const QStringList &strings)
+    : QTreeWidgetItem(strings)
+{
+
+}
+
+DataTreeItem::DataTreeItem(QTreeWidget *parent, const QStringList &strings)
+    : QTreeWidgetItem(parent, strings)
+{
+
+}
+
+bool DataTreeItem::operator<(const QTreeWidgetItem &other) const
+{
+    const int column = treeWidget() ? treeWidget()->sortColumn() : 0;
+
+    bool this_ok, other_ok;
+    const double this_value = text(column).toDouble(&this_ok);
+    const double other_value = other.text(column).toDouble(&other_ok);
+
+    if (this_ok && other_ok) {
+        return this_value < other_value;
+    }
+    if (this_ok != other_ok) {
+        return other_ok;
+    }
+    return QTreeWidgetItem::operator<(other);
+}
@@ -0,0 +1,21 @@
+#ifndef DATATREEITEM_H
+#define DATATREEITEM_H
+
+#include <QTreeWidgetItem>
+
+/*
+ *     Tree item that sorts numeric columns by value
+ *
+ *     Empty or non-numeric texts sort below every number, so a descending
+ *     sort lists the largest values first.
+ */
+class DataTreeItem : public QTreeWidgetItem
+{
+public:
+    explicit DataTreeItem(const QStringList &strings);
+    DataTreeItem(QTreeWidget *parent, const QStringList &strings);
+
+    bool operator<(const QTreeWidgetItem &other) const override;
+};
+
+#endif // DATATREEITEM_H
@@ -0,0 +1,73 @@
+#include "densitymap.h"
+
+#include <QtConcurrent>
+#include <QThread>
+
+namespace {
+
+// below this many points a batch is binned on the calling thread
+const int parallel_points = 65536;
+
+struct BinTask
+{
+    const QPointF *points;
+    int count;
+    const DensityMap::Grid *grid;
+    QVector< quint32 > counts;
+};
+
+void binRange(const QPointF *points, int count, const DensityMap::Grid &grid, quint32 *counts)
+{
+    const double x_scale = grid.nx / (grid.x_upper - grid.x_lower);
+    const double y_scale = grid.ny / (grid.y_upper - grid.y_lower);
+
+    for (int p = 0; p < count; p++) {
+        const double x = (points[p].x() - grid.x_lower) * x_scale;
+        const double y = (points[p].y() - grid.y_lower) * y_scale;
+        if (!(x >= 0.0) || !(y >= 0.0) || (x >= grid.nx) || (y >= grid.ny)) continue;
+
+        counts[int(y) * grid.nx + int(x)]++;
+    }
+}
+
+void runBinTask(BinTask &task)
+{
+    task.counts.fill(0, task.grid->nx * task.grid->ny);
+    binRange(task.points, task.count, *task.grid, task.counts.data());
+}
+
+}
+
+/*
+ *     Add points[first..] to counts, which holds nx * ny cells row by row
+ */
+void DensityMap::binPoints(const QVector< QPointF > &points, int first, const Grid &grid, QVector< quint32 > &counts)
+{
+    const int count = points.size() - first;
+    if ((count <= 0) || (grid.nx <= 0) || (grid.ny <= 0) || !(grid.x_upper > grid.x_lower) || !(grid.y_upper > grid.y_lower)) {
+        return;
+    }
+
+    if (count < parallel_points) {
+        binRange(points.constData() + first, count, grid, counts.data());
+        return;
+    }
+
+    const int task_cnt = qMax(1, qMin(QThread::idealThreadCount(), count / parallel_points));
+    QVector< BinTask > tasks(task_cnt);
+    for (int t = 0; t < task_cnt; t++) {
+        const int begin = first + qint64(count) * t / task_cnt;
+        const int end = first + qint64(count) * (t + 1) / task_cnt;
+        tasks[t].points = points.constData() + begin;
+        tasks[t].count = end - begin;
+        tasks[t].grid = &grid;
+    }
+    QtConcurrent::blockingMap(tasks, runBinTask);
+
+    for (int t = 0; t < task_cnt; t++) {
+        const quint32 *task_counts = tasks[t].counts.constData();
+        for (int c = 0; c < counts.size(); c++) {
+            counts[c] += task_counts[c];
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef DENSITYMAP_H
+#define DENSITYMAP_H
+
+#include <QVector>
+#include <QPointF>
+#include <QtGlobal>
+
+/*
+ *     2-D histogram of points over a fixed grid
+ *
+ *     Cell (i, j) covers x in [x_lower + i * dx, x_lower + (i + 1) * dx)
+ *     and likewise for y; points outside the grid are skipped. Large
+ *     batches are binned on the thread pool, one private histogram per
+ *     thread, then summed.
+ */
+namespace DensityMap {
+
+struct Grid
+{
+    double x_lower;
+    double x_upper;
+    double y_lower;
+    double y_upper;
+    int nx;
+    int ny;
+
+    bool operator==(const Grid &other) const
+    {
+        return (x_lower == other.x_lower) && (x_upper == other.x_upper) &&
+               (y_lower == other.y_lower) && (y_upper == other.y_upper) &&
+               (nx == other.nx) && (ny == other.ny);
+    }
+};
+
+void binPoints(const QVector< QPointF > &points, int first, const Grid &grid, QVector< quint32 > &counts);
+
+}
+
+#endif // DENSITYMAP_H
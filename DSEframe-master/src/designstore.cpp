@@ -0,0 +1,169 @@
+#include "designstore.h"
+
+#include <QtNumeric>
+#include <QAtomicInt>
+
+namespace {
+
+// stores are also filled on pool threads by the batch report
+QAtomicInt generation_cnt;
+
+}
+
+const int DesignStore::block_rows;
+
+DesignStore::DesignStore()
+{
+    clear();
+}
+
+void DesignStore::clear()
+{
+    column_names.clear();
+    columns.clear();
+    missing_cnt.clear();
+    row_cnt = 0;
+    store_generation = generation_cnt.fetchAndAddRelaxed(1) + 1;
+    group_ids.clear();
+    group_begin.clear();
+}
+
+void DesignStore::setHeader(const QStringList &header)
+{
+    clear();
+    column_names = header;
+    columns.resize(header.size());
+    missing_cnt.fill(0, header.size());
+}
+
+/*
+ *     Append one CSV row; a group id past the last one opens a new group
+ */
+void DesignStore::appendRow(int group, const QStringList &fields)
+{
+    while (group_begin.size() <= group) {
+        group_begin.append(row_cnt);
+    }
+
+    if (row_cnt % block_rows == 0) {
+        group_ids.append(QVector< int >());
+        group_ids.last().reserve(block_rows);
+        for (int i = 0; i < columns.size(); i++) {
+            columns[i].append(QVector< double >());
+            columns[i].last().reserve(block_rows);
+        }
+    }
+    group_ids.last().append(group);
+
+    for (int i = 0; i < columns.size(); i++) {
+        double value = (i < fields.size()) ? parseValue(fields.at(i)) : qQNaN();
+        if (qIsNaN(value)) {
+            missing_cnt[i]++;
+        }
+        columns[i].last().append(value);
+    }
+    row_cnt++;
+}
+
+bool DesignStore::isNumeric(int column) const
+{
+    return (rowCount() > 0) && (missing_cnt[column] == 0);
+}
+
+int DesignStore::groupEnd(int group) const
+{
+    return (group + 1 < group_begin.size()) ? group_begin[group + 1] : row_cnt;
+}
+
+/*
+ *     Rows of a group as row-major points over the given columns
+ */
+QVector< double > DesignStore::groupPoints(int group, const QVector< int > &point_columns) const
+{
+    QVector< double > points;
+    if ((group < 0) || (group >= group_begin.size())) {
+        return points;
+    }
+
+    const int begin = groupBegin(group);
+    const int end = groupEnd(group);
+    points.reserve((end - begin) * point_columns.size());
+    for (int row = begin; row < end; row++) {
+        for (int k = 0; k < point_columns.size(); k++) {
+            points.append(value(point_columns[k], row));
+        }
+    }
+
+    return points;
+}
+
+/*
+ *     Row as a point of the design space plot; a missing field is placed
+ *     at 0, so every row of a group keeps its point
+ */
+QPointF DesignStore::plotPoint(int row, int x_column, int y_column) const
+{
+    const double x = value(x_column, row);
+    const double y = value(y_column, row);
+    return QPointF(qIsNaN(x) ? 0.0 : x, qIsNaN(y) ? 0.0 : y);
+}
+
+/*
+ *     Grow the range of every column by the finite values of the rows from
+ *     first_row on that belong to visible groups, and count those rows
+ *
+ *     A view passes the rows appended since its last call, so the rows it
+ *     already ranged are not read again.
+ */
+int DesignStore::extendRanges(const QVector< bool > &visible_groups, int first_row, QVector< double > &low, QVector< double > &high) const
+{
+    if ((low.size() != columns.size()) || (high.size() != columns.size())) {
+        low.fill(qInf(), columns.size());
+        high.fill(-qInf(), columns.size());
+    }
+
+    int visible_cnt = 0;
+    for (int b = first_row / block_rows; b < group_ids.size(); b++) {
+        const int base = b * block_rows;
+        const int first = qMax(first_row - base, 0);
+        const QVector< int > &groups = group_ids[b];
+
+        for (int i = first; i < groups.size(); i++) {
+            visible_cnt += visible_groups.value(groups[i]) ? 1 : 0;
+        }
+
+        for (int c = 0; c < columns.size(); c++) {
+            const double *values = columns[c][b].constData();
+            double column_low = low[c];
+            double column_high = high[c];
+            for (int i = first; i < groups.size(); i++) {
+                if (!visible_groups.value(groups[i]) || !qIsFinite(values[i])) continue;
+
+                column_low = qMin(column_low, values[i]);
+                column_high = qMax(column_high, values[i]);
+            }
+            low[c] = column_low;
+            high[c] = column_high;
+        }
+    }
+
+    return visible_cnt;
+}
+
+double DesignStore::parseValue(const QString &field)
+{
+    bool ok;
+    double value = field.toDouble(&ok);
+    if (ok) {
+        return value;
+    }
+
+    // strip a unit suffix such as "ns"
+    QString number = field.trimmed();
+    while (!number.isEmpty() && number.at(number.size() - 1).isLetter()) {
+        number.chop(1);
+    }
+    value = number.toDouble(&ok);
+
+    return ok ? value : qQNaN();
+}
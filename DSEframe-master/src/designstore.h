@@ -0,0 +1,82 @@
+#ifndef DESIGNSTORE_H
+#define DESIGNSTORE_H
+
+#include <QVector>
+#include <QStringList>
+#include <QPointF>
+
+/*
+ *     Column store of every design read from the CSV file
+ *
+ *     Each column holds one double per row; fields that cannot be read as a
+ *     number (such as "-") are stored as NaN. A unit suffix like the "ns"
+ *     of cp_delay is ignored. Rows arrive grouped by Method/Iteration, so
+ *     the rows of a group are contiguous.
+ *
+ *     Columns are kept in blocks of block_rows rows, and a full block is
+ *     never written again. A copy of the store is an append-only snapshot:
+ *     it shares every block with the original, and rows appended to the
+ *     original afterwards only copy the last, partly filled block of each
+ *     column. Copies share the generation of the store until it is
+ *     cleared.
+ */
+class DesignStore
+{
+public:
+    DesignStore();
+
+    void clear();
+
+    void setHeader(const QStringList &header);
+
+    void appendRow(int group, const QStringList &fields);
+
+    // rows per block, a whole number of 64-bit words of a row bitset
+    static const int block_rows = 4096;
+
+    int rowCount() const { return row_cnt; }
+
+    int columnCount() const { return column_names.size(); }
+
+    int groupCount() const { return group_begin.size(); }
+
+    const QStringList &columnNames() const { return column_names; }
+
+    int columnIndex(const QString &name) const { return column_names.indexOf(name); }
+
+    bool isNumeric(int column) const;
+
+    int blockCount() const { return group_ids.size(); }
+
+    const QVector< double > &columnBlock(int column, int block) const { return columns[column][block]; }
+
+    const QVector< int > &groupBlock(int block) const { return group_ids[block]; }
+
+    double value(int column, int row) const { return columns[column][row / block_rows][row % block_rows]; }
+
+    int generation() const { return store_generation; }
+
+    int groupBegin(int group) const { return group_begin[group]; }
+
+    int groupEnd(int group) const;
+
+    QVector< double > groupPoints(int group, const QVector< int > &point_columns) const;
+
+    QPointF plotPoint(int row, int x_column, int y_column) const;
+
+    int extendRanges(const QVector< bool > &visible_groups, int first_row, QVector< double > &low, QVector< double > &high) const;
+
+    static double parseValue(const QString &field);
+
+private:
+    QStringList column_names;
+    QVector< QVector< QVector< double > > > columns;
+    QVector< int > missing_cnt;
+    int row_cnt;
+    int store_generation;
+
+    QVector< QVector< int > > group_ids;
+    QVector< int > group_begin;
+};
+
+#endif // DESIGNSTORE_H
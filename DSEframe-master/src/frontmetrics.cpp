@@ -0,0 +1,335 @@
+#include "frontmetrics.h"
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FRONTMETRICS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+bool lessX(const QPointF &a, double x)
+{
+    return a.x() < x;
+}
+
+double squaredDistance(const QPointF &a, const QPointF &b)
+{
+    const double dx = a.x() - b.x();
+    const double dy = a.y() - b.y();
+    return dx * dx + dy * dy;
+}
+
+double norm(const QPointF &a)
+{
+    return sqrt(a.x() * a.x() + a.y() * a.y());
+}
+
+/*
+ *     Exact bit pattern of a point, with -0.0 folded into 0.0
+ */
+QPair< quint64, quint64 > pointKey(const QPointF &a)
+{
+    const double x = a.x() + 0.0;
+    const double y = a.y() + 0.0;
+
+    QPair< quint64, quint64 > key;
+    memcpy(&key.first, &x, sizeof(x));
+    memcpy(&key.second, &y, sizeof(y));
+    return key;
+}
+
+/*
+ *     Nearest-point reductions from one reference point to every front point
+ *
+ *     Two front points per SSE2 register over the contiguous coordinate
+ *     arrays, then a scalar tail.
+ */
+struct Reductions
+{
+    double distance2;
+    double distance_plus2;
+    double epsilon_add;
+    double epsilon_mult;
+};
+
+Reductions reduceFront(const double *x, const double *y, int n, double rx, double ry)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    Reductions result = { inf, inf, inf, inf };
+
+    const double inv_rx = 1.0 / rx;
+    const double inv_ry = 1.0 / ry;
+
+    int j = 0;
+#ifdef FRONTMETRICS_SSE2
+    const __m128d v_rx = _mm_set1_pd(rx);
+    const __m128d v_ry = _mm_set1_pd(ry);
+    const __m128d v_inv_rx = _mm_set1_pd(inv_rx);
+    const __m128d v_inv_ry = _mm_set1_pd(inv_ry);
+    const __m128d v_zero = _mm_setzero_pd();
+    __m128d v_d2 = _mm_set1_pd(inf);
+    __m128d v_d_plus2 = _mm_set1_pd(inf);
+    __m128d v_add = _mm_set1_pd(inf);
+    __m128d v_mult = _mm_set1_pd(inf);
+
+    for (; j + 2 <= n; j += 2) {
+        const __m128d px = _mm_loadu_pd(x + j);
+        const __m128d py = _mm_loadu_pd(y + j);
+        const __m128d dx = _mm_sub_pd(px, v_rx);
+        const __m128d dy = _mm_sub_pd(py, v_ry);
+        const __m128d dx_plus = _mm_max_pd(dx, v_zero);
+        const __m128d dy_plus = _mm_max_pd(dy, v_zero);
+
+        v_d2 = _mm_min_pd(v_d2, _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+        v_d_plus2 = _mm_min_pd(v_d_plus2, _mm_add_pd(_mm_mul_pd(dx_plus, dx_plus), _mm_mul_pd(dy_plus, dy_plus)));
+        v_add = _mm_min_pd(v_add, _mm_max_pd(dx, dy));
+        v_mult = _mm_min_pd(v_mult, _mm_max_pd(_mm_mul_pd(px, v_inv_rx), _mm_mul_pd(py, v_inv_ry)));
+    }
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, v_d2);
+    result.distance2 = qMin(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, v_d_plus2);
+    result.distance_plus2 = qMin(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, v_add);
+    result.epsilon_add = qMin(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, v_mult);
+    result.epsilon_mult = qMin(lanes[0], lanes[1]);
+#endif
+
+    for (; j < n; j++) {
+        const double dx = x[j] - rx;
+        const double dy = y[j] - ry;
+        const double dx_plus = qMax(dx, 0.0);
+        const double dy_plus = qMax(dy, 0.0);
+
+        result.distance2 = qMin(result.distance2, dx * dx + dy * dy);
+        result.distance_plus2 = qMin(result.distance_plus2, dx_plus * dx_plus + dy_plus * dy_plus);
+        result.epsilon_add = qMin(result.epsilon_add, qMax(dx, dy));
+        result.epsilon_mult = qMin(result.epsilon_mult, qMax(x[j] * inv_rx, y[j] * inv_ry));
+    }
+
+    return result;
+}
+
+double distance(const QPointF &a, const QPointF &b)
+{
+    return sqrt(squaredDistance(a, b));
+}
+
+}
+
+/*
+ *     Index of the front point nearest to a given point
+ *
+ *     The front is sorted by x, so the search starts at the x insertion
+ *     position and walks outwards in both directions, stopping as soon as
+ *     the x gap alone exceeds the best squared distance found. Ties go to
+ *     the lowest index, like a plain linear scan.
+ */
+int FrontMetrics::nearestPoint(const QVector< QPointF > &front, const QPointF &point, double *distance2)
+{
+    const int start = std::lower_bound(front.constBegin(), front.constEnd(), point.x(), lessX) - front.constBegin();
+
+    int mark = -1;
+    double min_dis2 = std::numeric_limits<double>::infinity();
+
+    for (int j = start; j < front.size(); j++) {
+        const double dx = front[j].x() - point.x();
+        if (dx * dx > min_dis2) break;
+
+        const double dis2 = squaredDistance(front[j], point);
+        if (dis2 < min_dis2) {
+            min_dis2 = dis2;
+            mark = j;
+        }
+    }
+
+    for (int j = start - 1; j >= 0; j--) {
+        const double dx = point.x() - front[j].x();
+        if (dx * dx > min_dis2) break;
+
+        const double dis2 = squaredDistance(front[j], point);
+        if (dis2 <= min_dis2) {
+            min_dis2 = dis2;
+            mark = j;
+        }
+    }
+
+    if (distance2) {
+        *distance2 = min_dis2;
+    }
+    return mark;
+}
+
+/*
+ *     Average Distance to Reference Set
+ *
+ *     Mean of the normalized nearest distances from the front to the
+ *     reference and from the reference to the front. Each distance is
+ *     normalized by the norm of the reference point it was measured to.
+ */
+double FrontMetrics::adrs(const QVector< QPointF > &front, const QVector< QPointF > &reference)
+{
+    if (front.isEmpty() || reference.isEmpty()) {
+        return 0.0;
+    }
+
+    double adrs1 = 0.0;
+    for (int i = 0; i < front.size(); i++) {
+        double distance2;
+        const int mark = nearestPoint(reference, front[i], &distance2);
+        adrs1 += sqrt(distance2) / norm(reference[mark]);
+    }
+    adrs1 /= front.size();
+
+    double adrs2 = 0.0;
+    for (int i = 0; i < reference.size(); i++) {
+        double distance2;
+        nearestPoint(front, reference[i], &distance2);
+        adrs2 += sqrt(distance2) / norm(reference[i]);
+    }
+    adrs2 /= reference.size();
+
+    return (adrs1 + adrs2) / 2;
+}
+
+/*
+ *     Exact bit patterns of the points of a reference front, built once
+ *     and shared by the dominance of every method against it
+ */
+FrontMetrics::PointSet FrontMetrics::pointSet(const QVector< QPointF > &points)
+{
+    PointSet keys;
+    keys.reserve(points.size());
+    for (int i = 0; i < points.size(); i++) {
+        keys.insert(pointKey(points[i]));
+    }
+    return keys;
+}
+
+/*
+ *     Share of the reference front that is also on the front
+ *
+ *     For reference fronts that do not record which method contributed each
+ *     point; points are matched exactly through the hash set of the
+ *     reference.
+ */
+double FrontMetrics::dominance(const QVector< QPointF > &front, const PointSet &reference)
+{
+    if (reference.isEmpty()) {
+        return 0.0;
+    }
+
+    int dominance_cnt = 0;
+    for (int i = 0; i < front.size(); i++) {
+        if (reference.contains(pointKey(front[i]))) {
+            dominance_cnt++;
+        }
+    }
+
+    return (double)dominance_cnt / reference.size();
+}
+
+QString FrontMetrics::indicatorName(int indicator)
+{
+    switch (indicator) {
+    case IGD:                   return "IGD";
+    case IGDPlus:               return "IGD+";
+    case EpsilonAdditive:       return "Epsilon+";
+    case EpsilonMultiplicative: return "Epsilon*";
+    case Spread:                return "Spread";
+    case Spacing:               return "Spacing";
+    default:                    return "";
+    }
+}
+
+/*
+ *     All indicators of the front against the reference front at once
+ *
+ *     IGD, IGD+ and both epsilon indicators share one pass over the
+ *     reference points. Spread (Deb's delta, against the extremes of the
+ *     reference) and spacing (Schott, L1 gaps) only need consecutive front
+ *     points, since the front is sorted. The multiplicative epsilon needs
+ *     positive reference values and is NaN otherwise.
+ */
+QVector< double > FrontMetrics::indicators(const QVector< QPointF > &front, const QVector< QPointF > &reference)
+{
+    QVector< double > values(IndicatorCount, std::numeric_limits<double>::quiet_NaN());
+    if (front.isEmpty() || reference.isEmpty()) {
+        return values;
+    }
+
+    const int n = front.size();
+    QVector< double > x(n), y(n);
+    for (int j = 0; j < n; j++) {
+        x[j] = front[j].x();
+        y[j] = front[j].y();
+    }
+
+    double igd = 0.0;
+    double igd_plus = 0.0;
+    double epsilon_add = -std::numeric_limits<double>::infinity();
+    double epsilon_mult = -std::numeric_limits<double>::infinity();
+    bool positive = true;
+    for (int i = 0; i < reference.size(); i++) {
+        const Reductions r = reduceFront(x.constData(), y.constData(), n, reference[i].x(), reference[i].y());
+        igd += sqrt(r.distance2);
+        igd_plus += sqrt(r.distance_plus2);
+        epsilon_add = qMax(epsilon_add, r.epsilon_add);
+        epsilon_mult = qMax(epsilon_mult, r.epsilon_mult);
+        positive = positive && (reference[i].x() > 0.0) && (reference[i].y() > 0.0);
+    }
+    values[IGD] = igd / reference.size();
+    values[IGDPlus] = igd_plus / reference.size();
+    values[EpsilonAdditive] = epsilon_add;
+    if (positive) {
+        values[EpsilonMultiplicative] = epsilon_mult;
+    }
+
+    // Spread
+    const double d_first = distance(front.first(), reference.first());
+    const double d_last = distance(front.last(), reference.last());
+    double d_mean = 0.0;
+    for (int j = 1; j < n; j++) {
+        d_mean += distance(front[j - 1], front[j]);
+    }
+    d_mean = (n > 1) ? d_mean / (n - 1) : 0.0;
+
+    double d_deviation = 0.0;
+    for (int j = 1; j < n; j++) {
+        d_deviation += qAbs(distance(front[j - 1], front[j]) - d_mean);
+    }
+    const double spread_base = d_first + d_last + (n - 1) * d_mean;
+    values[Spread] = (spread_base > 0.0) ? (d_first + d_last + d_deviation) / spread_base : 0.0;
+
+    // Spacing: on a staircase the L1-nearest point is a neighbour
+    if (n > 1) {
+        QVector< double > gap(n);
+        for (int j = 0; j < n; j++) {
+            double gap_left = std::numeric_limits<double>::infinity();
+            double gap_right = std::numeric_limits<double>::infinity();
+            if (j > 0) gap_left = qAbs(x[j] - x[j - 1]) + qAbs(y[j] - y[j - 1]);
+            if (j + 1 < n) gap_right = qAbs(x[j + 1] - x[j]) + qAbs(y[j + 1] - y[j]);
+            gap[j] = qMin(gap_left, gap_right);
+        }
+
+        double gap_mean = 0.0;
+        for (int j = 0; j < n; j++) gap_mean += gap[j];
+        gap_mean /= n;
+
+        double spacing = 0.0;
+        for (int j = 0; j < n; j++) spacing += (gap_mean - gap[j]) * (gap_mean - gap[j]);
+        values[Spacing] = sqrt(spacing / (n - 1));
+    }
+    else {
+        values[Spacing] = 0.0;
+    }
+
+    return values;
+}
@@ -0,0 +1,44 @@
+#ifndef FRONTMETRICS_H
+#define FRONTMETRICS_H
+
+#include <QVector>
+#include <QPointF>
+#include <QString>
+#include <QSet>
+#include <QPair>
+
+/*
+ *     Quality indicators of a 2-D Pareto front against a reference front
+ *
+ *     Both fronts are expected in the ParetoFront layout: sorted by
+ *     increasing x, each value present once.
+ */
+namespace FrontMetrics {
+
+int nearestPoint(const QVector< QPointF > &front, const QPointF &point, double *distance2 = 0);
+
+double adrs(const QVector< QPointF > &front, const QVector< QPointF > &reference);
+
+typedef QSet< QPair< quint64, quint64 > > PointSet;
+
+PointSet pointSet(const QVector< QPointF > &points);
+
+double dominance(const QVector< QPointF > &front, const PointSet &reference);
+
+enum Indicator {
+    IGD,
+    IGDPlus,
+    EpsilonAdditive,
+    EpsilonMultiplicative,
+    Spread,
+    Spacing,
+    IndicatorCount
+};
+
+QString indicatorName(int indicator);
+
+QVector< double > indicators(const QVector< QPointF > &front, const QVector< QPointF > &reference);
+
+}
+
+#endif // FRONTMETRICS_H
@@ -0,0 +1,95 @@
+#include "groupfronts.h"
+
+GroupFronts::GroupFronts(QCPAxis *keyAxis, QCPAxis *valueAxis)
+    : QCPAbstractPlottable(keyAxis, valueAxis),
+      group_fronts(0),
+      default_size(4)
+{
+    setSelectable(QCP::stNone);
+}
+
+double GroupFronts::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+{
+    Q_UNUSED(pos)
+    Q_UNUSED(onlySelectable)
+    Q_UNUSED(details)
+    return -1;
+}
+
+QCPRange GroupFronts::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+    return getRange(true, foundRange, inSignDomain);
+}
+
+QCPRange GroupFronts::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+{
+    Q_UNUSED(inKeyRange)
+    return getRange(false, foundRange, inSignDomain);
+}
+
+QCPRange GroupFronts::getRange(bool keys, bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+    QCPRange range;
+    foundRange = false;
+    for (int g = 0; group_fronts && (g < group_fronts->size()); g++) {
+        if (!group_visible.value(g)) continue;
+
+        const QVector< QPointF > &front = group_fronts->at(g);
+        for (int i = 0; i < front.size(); i++) {
+            const double v = keys ? front[i].x() : front[i].y();
+            if (((inSignDomain == QCP::sdPositive) && (v <= 0)) || ((inSignDomain == QCP::sdNegative) && (v >= 0))) continue;
+
+            if (!foundRange) {
+                range = QCPRange(v, v);
+                foundRange = true;
+            }
+            range.expand(v);
+        }
+    }
+    return range;
+}
+
+void GroupFronts::draw(QCPPainter *painter)
+{
+    if (!group_fronts) {
+        return;
+    }
+
+    QCPAxis *key_axis = mKeyAxis.data();
+    QCPAxis *value_axis = mValueAxis.data();
+    const bool horizontal = (key_axis->orientation() == Qt::Horizontal);
+
+    QVector< QPointF > pixels;
+    QCPScatterStyle style(QCPScatterStyle::ssDisc, default_size);
+    for (int g = 0; g < group_fronts->size(); g++) {
+        const QVector< QPointF > &front = group_fronts->at(g);
+        if (!group_visible.value(g) || front.isEmpty()) continue;
+
+        pixels.resize(front.size());
+        for (int i = 0; i < front.size(); i++) {
+            const double key_pixel = key_axis->coordToPixel(front[i].x());
+            const double value_pixel = value_axis->coordToPixel(front[i].y());
+            pixels[i] = horizontal ? QPointF(key_pixel, value_pixel) : QPointF(value_pixel, key_pixel);
+        }
+
+        const QPen pen(palette.value(g, Qt::black));
+        applyDefaultAntialiasingHint(painter);
+        painter->setPen(pen);
+        painter->setBrush(Qt::NoBrush);
+        painter->drawPolyline(pixels.constData(), pixels.size());
+
+        const QVector< double > sizes = point_sizes.value(g);
+        applyScattersAntialiasingHint(painter);
+        style.applyTo(painter, pen);
+        for (int i = 0; i < pixels.size(); i++) {
+            style.setSize((sizes.size() == pixels.size()) ? sizes[i] : default_size);
+            style.drawShape(painter, pixels[i]);
+        }
+    }
+}
+
+void GroupFronts::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
+{
+    painter->setPen(QPen(palette.value(0, Qt::black)));
+    painter->drawLine(QLineF(rect.left(), rect.center().y(), rect.right(), rect.center().y()));
+}
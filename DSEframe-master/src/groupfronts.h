@@ -0,0 +1,50 @@
+#ifndef GROUPFRONTS_H
+#define GROUPFRONTS_H
+
+#include "qcustomplot.h"
+
+/*
+ *     Pareto fronts of every method group in one plottable
+ *
+ *     Each visible group is drawn as a line through its front points with
+ *     a disc on every point, in palette color g. A group's discs can have
+ *     their own sizes, given in front order; without them they all get
+ *     the default size. The fronts are read in place.
+ */
+class GroupFronts : public QCPAbstractPlottable
+{
+    Q_OBJECT
+
+public:
+    GroupFronts(QCPAxis *keyAxis, QCPAxis *valueAxis);
+
+    void setFronts(const QVector< QVector< QPointF > > *fronts) { group_fronts = fronts; }
+
+    void setPalette(const QVector< QColor > &colors) { palette = colors; }
+
+    void setGroupsVisible(const QVector< bool > &visible) { group_visible = visible; }
+
+    void setPointSizes(const QVector< QVector< double > > &sizes) { point_sizes = sizes; }
+
+    double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details = 0) const override;
+
+    QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain = QCP::sdBoth) const override;
+
+    QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain = QCP::sdBoth, const QCPRange &inKeyRange = QCPRange()) const override;
+
+protected:
+    void draw(QCPPainter *painter) override;
+
+    void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const override;
+
+private:
+    QCPRange getRange(bool keys, bool &foundRange, QCP::SignDomain inSignDomain) const;
+
+    const QVector< QVector< QPointF > > *group_fronts;
+    QVector< QColor > palette;
+    QVector< bool > group_visible;
+    QVector< QVector< double > > point_sizes;
+    double default_size;
+};
+
+#endif // GROUPFRONTS_H
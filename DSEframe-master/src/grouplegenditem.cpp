@@ -0,0 +1,95 @@
+#include "grouplegenditem.h"
+
+GroupLegendItem::GroupLegendItem(QCPLegend *parent)
+    : QCPAbstractLegendItem(parent),
+      first_row(0),
+      row_limit(20)
+{
+
+}
+
+/*
+ *     List the given groups; names and colors are indexed like groups.
+ *     The window keeps its position when it can.
+ */
+void GroupLegendItem::setGroups(const QVector< int > &groups, const QStringList &names, const QVector< QColor > &colors)
+{
+    group_ids = groups;
+    group_names = names;
+    group_colors = colors;
+    first_row = qBound(0, first_row, qMax(0, group_ids.size() - row_limit));
+}
+
+/*
+ *     Group listed at a pixel of the plot, or -1
+ */
+int GroupLegendItem::groupAt(const QPoint &pos) const
+{
+    if (!mRect.contains(pos)) {
+        return -1;
+    }
+    const int row = (pos.y() - mRect.top()) / rowHeight();
+    return (row < windowSize()) ? group_ids[first_row + row] : -1;
+}
+
+int GroupLegendItem::rowHeight() const
+{
+    return qMax(QFontMetrics(mFont).height(), mParentLegend->iconSize().height());
+}
+
+void GroupLegendItem::draw(QCPPainter *painter)
+{
+    const QSize icon_size = mParentLegend->iconSize();
+    const int height = rowHeight();
+    const int text_x = mRect.x() + icon_size.width() + mParentLegend->iconTextPadding();
+
+    painter->setFont(mFont);
+    for (int row = 0; row < windowSize(); row++) {
+        const int y = mRect.y() + row * height;
+        const QRectF icon_rect(mRect.x(), y + (height - icon_size.height()) / 2, icon_size.width(), icon_size.height());
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(group_colors.value(first_row + row, Qt::black));
+        painter->drawRect(icon_rect.adjusted(0, icon_size.height() / 3.0, 0, -icon_size.height() / 3.0));
+
+        painter->setPen(QPen(mTextColor));
+        painter->drawText(text_x, y, mRect.right() - text_x, height, Qt::AlignVCenter | Qt::TextDontClip, group_names.value(first_row + row));
+    }
+
+    if (group_ids.size() > row_limit) {
+        const int y = mRect.y() + windowSize() * height;
+        painter->setPen(QPen(mTextColor));
+        painter->drawText(text_x, y, mRect.right() - text_x, height, Qt::AlignVCenter | Qt::TextDontClip,
+                          tr("%1-%2 of %3").arg(first_row + 1).arg(first_row + windowSize()).arg(group_ids.size()));
+    }
+}
+
+QSize GroupLegendItem::minimumOuterSizeHint() const
+{
+    const QFontMetrics metrics(mFont);
+    int text_width = 0;
+    for (int row = 0; row < windowSize(); row++) {
+        text_width = qMax(text_width, metrics.boundingRect(group_names.value(first_row + row)).width());
+    }
+
+    const int rows = windowSize() + ((group_ids.size() > row_limit) ? 1 : 0);
+    QSize result(mParentLegend->iconSize().width() + mParentLegend->iconTextPadding() + text_width, rows * rowHeight());
+    result.rwidth() += mMargins.left() + mMargins.right();
+    result.rheight() += mMargins.top() + mMargins.bottom();
+    return result;
+}
+
+/*
+ *     Scroll the window by three groups per wheel step
+ */
+void GroupLegendItem::wheelEvent(QWheelEvent *event)
+{
+    if (group_ids.size() <= row_limit) {
+        event->ignore();
+        return;
+    }
+
+    const int steps = event->angleDelta().y() / 120;
+    first_row = qBound(0, first_row - 3 * steps, group_ids.size() - row_limit);
+    mParentPlot->replot(QCustomPlot::rpQueuedReplot);
+    event->accept();
+}
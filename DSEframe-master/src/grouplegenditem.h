@@ -0,0 +1,44 @@
+#ifndef GROUPLEGENDITEM_H
+#define GROUPLEGENDITEM_H
+
+#include "qcustomplot.h"
+
+/*
+ *     Legend entry listing the visible method groups
+ *
+ *     However many groups there are, it shows a window of at most
+ *     row_limit of them, one line each with a color swatch; the mouse
+ *     wheel scrolls the window. Only the lines in the window are measured
+ *     and drawn, so the legend stays cheap with thousands of groups.
+ */
+class GroupLegendItem : public QCPAbstractLegendItem
+{
+    Q_OBJECT
+
+public:
+    explicit GroupLegendItem(QCPLegend *parent);
+
+    void setGroups(const QVector< int > &groups, const QStringList &names, const QVector< QColor > &colors);
+
+    int groupAt(const QPoint &pos) const;
+
+protected:
+    void draw(QCPPainter *painter) override;
+
+    QSize minimumOuterSizeHint() const override;
+
+    void wheelEvent(QWheelEvent *event) override;
+
+private:
+    int rowHeight() const;
+
+    int windowSize() const { return qMin(row_limit, group_ids.size() - first_row); }
+
+    QVector< int > group_ids;
+    QStringList group_names;
+    QVector< QColor > group_colors;
+    int first_row;
+    int row_limit;
+};
+
+#endif // GROUPLEGENDITEM_H
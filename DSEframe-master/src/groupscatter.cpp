@@ -0,0 +1,333 @@
+#include "groupscatter.h"
+#include "pointraster.h"
+
+namespace {
+
+// markers above which discs are splatted into an image instead of painted
+const int raster_threshold = 4096;
+
+}
+
+GroupScatter::GroupScatter(QCPAxis *keyAxis, QCPAxis *valueAxis)
+    : QCPAbstractPlottable(keyAxis, valueAxis),
+      group_points(0),
+      scatter_style(QCPScatterStyle::ssDisc, 4),
+      scatter_skip(0),
+      data_generation(0),
+      cached_key_log(false),
+      cached_value_log(false),
+      cache_valid(false),
+      raster_size(0.0),
+      raster_skip(0)
+{
+    setSelectable(QCP::stNone);
+}
+
+/*
+ *     Generation of the point sets, bumped whenever rows are cleared
+ *
+ *     Rows refilled past the old count between two draws would otherwise
+ *     look appended and keep the pixels of the cleared ones.
+ */
+void GroupScatter::setGeneration(int generation)
+{
+    if (generation != data_generation) {
+        cache_valid = false;
+    }
+    data_generation = generation;
+}
+
+/*
+ *     Show rows [begin[g], end[g]) of every group g
+ *
+ *     Only a grown end keeps the cached pixels.
+ */
+void GroupScatter::setRows(const QVector< int > &begin, const QVector< int > &end)
+{
+    if (begin != row_begin) {
+        cache_valid = false;
+    }
+    for (int g = 0; cache_valid && (g < end.size()); g++) {
+        cache_valid = (g >= row_end.size()) || (end[g] >= row_end[g]);
+    }
+    row_begin = begin;
+    row_end = end;
+}
+
+void GroupScatter::setGroupsVisible(const QVector< bool > &visible)
+{
+    if (visible != group_visible) {
+        cache_valid = false;
+    }
+    group_visible = visible;
+}
+
+/*
+ *     Draw the rows in the given pyramids from their tiles
+ *
+ *     The kept pixels were projected without them, so the next draw
+ *     starts over.
+ */
+void GroupScatter::setPyramids(const QVector< QSharedPointer< const PointPyramid > > &pyramids)
+{
+    if (pyramids != group_pyramids) {
+        cache_valid = false;
+    }
+    group_pyramids = pyramids;
+}
+
+double GroupScatter::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+{
+    Q_UNUSED(pos)
+    Q_UNUSED(onlySelectable)
+    Q_UNUSED(details)
+    return -1;
+}
+
+QCPRange GroupScatter::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+    return getRange(true, foundRange, inSignDomain);
+}
+
+QCPRange GroupScatter::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+{
+    Q_UNUSED(inKeyRange)
+    return getRange(false, foundRange, inSignDomain);
+}
+
+QCPRange GroupScatter::getRange(bool keys, bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+    QCPRange range;
+    foundRange = false;
+    for (int g = 0; group_points && (g < row_end.size()) && (g < group_points->size()); g++) {
+        if (!group_visible.value(g)) continue;
+
+        const QVector< QPointF > &points = group_points->at(g);
+        for (int i = row_begin.value(g); i < row_end[g]; i++) {
+            const double v = keys ? points[i].x() : points[i].y();
+            if (!qIsFinite(v) || ((inSignDomain == QCP::sdPositive) && (v <= 0)) || ((inSignDomain == QCP::sdNegative) && (v >= 0))) continue;
+
+            if (!foundRange) {
+                range = QCPRange(v, v);
+                foundRange = true;
+            }
+            range.expand(v);
+        }
+    }
+    return range;
+}
+
+void GroupScatter::draw(QCPPainter *painter)
+{
+    if (!group_points || scatter_style.isNone()) {
+        return;
+    }
+
+    updatePixels();
+
+    if (drawRaster(painter)) {
+        return;
+    }
+
+    applyScattersAntialiasingHint(painter);
+    for (int g = 0; g < pixels.size(); g++) {
+        if (pixels[g].isEmpty()) continue;
+
+        scatter_style.applyTo(painter, QPen(palette.value(g, Qt::black)));
+        for (int i = 0; i < pixels[g].size(); i += scatter_skip + 1) {
+            scatter_style.drawShape(painter, pixels[g][i]);
+        }
+    }
+}
+
+/*
+ *     Splat the kept discs into an image on the thread pool and blit it
+ *
+ *     Only used for many discs on a pixel buffer; vector output (PDF,
+ *     printing) and the other marker shapes keep painting each marker.
+ *     While the kept pixels only grew and the look stays the same, just
+ *     the new pixels are splatted over the image of the last draw.
+ */
+bool GroupScatter::drawRaster(QCPPainter *painter)
+{
+    if (painter->modes().testFlag(QCPPainter::pmVectorized) || (scatter_style.shape() != QCPScatterStyle::ssDisc)) {
+        return false;
+    }
+
+    int marker_cnt = 0;
+    for (int g = 0; g < pixels.size(); g++) {
+        marker_cnt += pixels[g].size() / (scatter_skip + 1);
+    }
+    if (marker_cnt < raster_threshold) {
+        raster = QImage();
+        return false;
+    }
+
+    const double ratio = mParentPlot->bufferDevicePixelRatio();
+    const int margin = qCeil(scatter_style.size() / 2) + 1;
+    const QRect rect = clipRect().toAlignedRect().adjusted(-margin, -margin, margin, margin);
+    const int stride = scatter_skip + 1;
+
+    bool keep = !raster.isNull() && (rect == raster_rect) && (ratio == raster.devicePixelRatio()) &&
+                (palette == raster_palette) && (scatter_style.size() == raster_size) && (scatter_skip == raster_skip) &&
+                (rastered_pixels.size() == pixels.size());
+    for (int g = 0; keep && (g < pixels.size()); g++) {
+        keep = (rastered_pixels[g] <= pixels[g].size());
+    }
+    if (!keep) {
+        raster = QImage(qCeil(rect.width() * ratio), qCeil(rect.height() * ratio), QImage::Format_ARGB32_Premultiplied);
+        raster.fill(Qt::transparent);
+        raster_rect = rect;
+        raster_palette = palette;
+        raster_size = scatter_style.size();
+        raster_skip = scatter_skip;
+        rastered_pixels.fill(0, pixels.size());
+    }
+
+    // Every stride-th pixel not splatted yet, counting from the first one
+    QVector< QVector< QPointF > > fresh(pixels.size());
+    QVector< PointRaster::Layer > layers;
+    for (int g = 0; g < pixels.size(); g++) {
+        for (int i = (rastered_pixels[g] + stride - 1) / stride * stride; i < pixels[g].size(); i += stride) {
+            fresh[g].append(pixels[g][i]);
+        }
+        rastered_pixels[g] = pixels[g].size();
+        if (fresh[g].isEmpty()) continue;
+
+        PointRaster::Layer layer;
+        layer.points = &fresh[g];
+        layer.color = qPremultiply(palette.value(g, Qt::black).rgba());
+        layers.append(layer);
+    }
+    if (!layers.isEmpty()) {
+        PointRaster::splat(raster.bits(), raster.width(), raster.height(), raster.bytesPerLine(), layers,
+                           scatter_style.size() * ratio, rect.topLeft(), ratio, 1);
+    }
+
+    raster.setDevicePixelRatio(ratio);
+    painter->drawImage(rect.topLeft(), raster);
+    return true;
+}
+
+void GroupScatter::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
+{
+    // The color of the first visible group stands for the rows
+    QColor color = Qt::black;
+    for (int g = 0; g < palette.size(); g++) {
+        if (group_visible.value(g)) {
+            color = palette[g];
+            break;
+        }
+    }
+    scatter_style.applyTo(painter, QPen(color));
+    scatter_style.drawShape(painter, rect.center());
+}
+
+/*
+ *     Bring the kept pixels up to date with the view and the rows
+ *
+ *     The occupancy grid covers the axis rect grown by half a marker, so
+ *     markers cut by the border are still drawn. Each pixel keeps the
+ *     group drawn on top, the last one: a full pass visits the groups from
+ *     the last one, and appended rows of a later group are kept over the
+ *     pixels of an earlier one, which are then painted beneath them.
+ */
+void GroupScatter::updatePixels()
+{
+    QCPAxis *key_axis = mKeyAxis.data();
+    QCPAxis *value_axis = mValueAxis.data();
+    const int margin = qCeil(scatter_style.size() / 2.0);
+    const QRect rect = key_axis->axisRect()->rect().adjusted(-margin, -margin, margin, margin);
+    const bool key_log = (key_axis->scaleType() == QCPAxis::stLogarithmic);
+    const bool value_log = (value_axis->scaleType() == QCPAxis::stLogarithmic);
+    const int group_cnt = qMin(row_end.size(), group_points->size());
+
+    if (!cache_valid || (key_axis->range() != cached_key_range) || (value_axis->range() != cached_value_range) ||
+        (rect != cached_rect) || (key_log != cached_key_log) || (value_log != cached_value_log)) {
+        cached_key_range = key_axis->range();
+        cached_value_range = value_axis->range();
+        cached_rect = rect;
+        cached_key_log = key_log;
+        cached_value_log = value_log;
+        cache_valid = true;
+        raster = QImage();
+        owners.fill(0, rect.width() * rect.height());
+        pixels.clear();
+        pixels.resize(group_cnt);
+        processed_rows = row_begin;
+        processed_rows.resize(group_cnt);
+
+        // The rows in a pyramid are drawn from its tiles of about a pixel
+        const bool horizontal = (key_axis->orientation() == Qt::Horizontal);
+        const bool use_pyramids = horizontal && !key_log && !value_log;
+        const double x_lower = key_axis->pixelToCoord(rect.left());
+        const double x_upper = key_axis->pixelToCoord(rect.right());
+        const double y_lower = value_axis->pixelToCoord(rect.bottom());
+        const double y_upper = value_axis->pixelToCoord(rect.top());
+        const QRectF view(x_lower, y_lower, x_upper - x_lower, y_upper - y_lower);
+
+        for (int g = group_cnt - 1; g >= 0; g--) {
+            if (!group_visible.value(g)) {
+                processed_rows[g] = row_end[g];
+                continue;
+            }
+
+            const QSharedPointer< const PointPyramid > pyramid = group_pyramids.value(g);
+            if (use_pyramids && pyramid && (row_begin.value(g) == 0) && (pyramid->size() <= row_end[g])) {
+                QVector< QPointF > points;
+                pyramid->visiblePoints(view, qAbs(x_upper - x_lower) / rect.width(), qAbs(y_upper - y_lower) / rect.height(), points);
+                for (int i = 0; i < points.size(); i++) {
+                    keepPixel(g, QPointF(key_axis->coordToPixel(points[i].x()), value_axis->coordToPixel(points[i].y())));
+                }
+                processed_rows[g] = pyramid->size();
+            }
+            projectRows(g, processed_rows[g], row_end[g]);
+            processed_rows[g] = row_end[g];
+        }
+        return;
+    }
+
+    pixels.resize(group_cnt);
+    processed_rows.resize(group_cnt);
+    for (int g = group_cnt - 1; g >= 0; g--) {
+        if (group_visible.value(g)) {
+            projectRows(g, qMax(processed_rows[g], row_begin.value(g)), row_end[g]);
+        }
+        processed_rows[g] = row_end[g];
+    }
+}
+
+void GroupScatter::projectRows(int group, int first, int last)
+{
+    QCPAxis *key_axis = mKeyAxis.data();
+    QCPAxis *value_axis = mValueAxis.data();
+    const bool horizontal = (key_axis->orientation() == Qt::Horizontal);
+    const QVector< QPointF > &points = group_points->at(group);
+
+    for (int i = first; i < last; i++) {
+        const double key_pixel = key_axis->coordToPixel(points[i].x());
+        const double value_pixel = value_axis->coordToPixel(points[i].y());
+        keepPixel(group, horizontal ? QPointF(key_pixel, value_pixel) : QPointF(value_pixel, key_pixel));
+    }
+}
+
+/*
+ *     Keep a pixel unless it is outside the grid or taken by the group
+ *     or a later one
+ */
+void GroupScatter::keepPixel(int group, const QPointF &pixel)
+{
+    const double x = pixel.x() - cached_rect.left();
+    const double y = pixel.y() - cached_rect.top();
+    if (!(x >= 0.0) || !(y >= 0.0) || (x >= cached_rect.width()) || (y >= cached_rect.height())) {
+        return;
+    }
+
+    const int cell = int(y) * cached_rect.width() + int(x);
+    const quint16 owner = quint16(qMin(group + 1, 0xffff));
+    if (owners[cell] >= owner) {
+        return;
+    }
+    owners[cell] = owner;
+    pixels[group].append(pixel);
+}
@@ -0,0 +1,100 @@
+#ifndef GROUPSCATTER_H
+#define GROUPSCATTER_H
+
+#include "qcustomplot.h"
+#include "pointpyramid.h"
+
+#include <QSharedPointer>
+
+/*
+ *     Unconnected markers of every method group in one plottable
+ *
+ *     The rows are read in place from the per-group point sets; group g
+ *     shows rows [begin[g], end[g]) in palette color g. All groups are
+ *     projected in one pass that keeps at most one marker per pixel, the
+ *     last group drawn winning, using a grid of pixel owners over the
+ *     axis rect. The
+ *     kept pixels are cached until the view, the rows shown or the visible
+ *     groups change; rows appended while the view stays are added without
+ *     projecting the earlier ones again. Given the pyramid of a group on
+ *     linear axes, a new view only projects the representatives of its
+ *     visible tiles. Many discs on a pixel buffer are splatted into an
+ *     image by the software rasterizer rather than painted one by one;
+ *     the image is kept with the pixels, so appended rows are splatted
+ *     over it and the earlier ones are not drawn again.
+ */
+class GroupScatter : public QCPAbstractPlottable
+{
+    Q_OBJECT
+
+public:
+    GroupScatter(QCPAxis *keyAxis, QCPAxis *valueAxis);
+
+    void setPointSets(const QVector< QVector< QPointF > > *point_sets) { group_points = point_sets; }
+
+    void setGeneration(int generation);
+
+    void setRows(const QVector< int > &begin, const QVector< int > &end);
+
+    void setPalette(const QVector< QColor > &colors) { palette = colors; }
+
+    void setGroupsVisible(const QVector< bool > &visible);
+
+    void setPyramids(const QVector< QSharedPointer< const PointPyramid > > &pyramids);
+
+    void setScatterStyle(const QCPScatterStyle &style) { scatter_style = style; }
+
+    void setScatterSkip(int skip) { scatter_skip = skip; }
+
+    double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details = 0) const override;
+
+    QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain = QCP::sdBoth) const override;
+
+    QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain = QCP::sdBoth, const QCPRange &inKeyRange = QCPRange()) const override;
+
+protected:
+    void draw(QCPPainter *painter) override;
+
+    void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const override;
+
+private:
+    void updatePixels();
+
+    bool drawRaster(QCPPainter *painter);
+
+    void projectRows(int group, int first, int last);
+
+    void keepPixel(int group, const QPointF &pixel);
+
+    QCPRange getRange(bool keys, bool &foundRange, QCP::SignDomain inSignDomain) const;
+
+    const QVector< QVector< QPointF > > *group_points;
+    QVector< int > row_begin;
+    QVector< int > row_end;
+    QVector< QColor > palette;
+    QVector< bool > group_visible;
+    QVector< QSharedPointer< const PointPyramid > > group_pyramids;
+    QCPScatterStyle scatter_style;
+    int scatter_skip;
+    int data_generation;
+
+    QCPRange cached_key_range;
+    QCPRange cached_value_range;
+    QRect cached_rect;
+    bool cached_key_log;
+    bool cached_value_log;
+    bool cache_valid;
+    QVector< int > processed_rows;
+
+    QVector< quint16 > owners;
+    QVector< QVector< QPointF > > pixels;
+
+    QImage raster;
+    QRect raster_rect;
+    QVector< QColor > raster_palette;
+    double raster_size;
+    int raster_skip;
+    QVector< int > rastered_pixels;
+};
+
+#endif // GROUPSCATTER_H
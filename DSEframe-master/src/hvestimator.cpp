@@ -0,0 +1,313 @@
+#include "hvestimator.h"
+#include "hypervolume.h"
+#include "random.h"
+
+#include <QtConcurrent>
+
+#include <math.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HV_AVX2_KERNEL
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const int chunk_samples = 4096;
+const int round_chunks = 16;
+
+/*
+ *     Front in column-major order, padded to a multiple of four points with
+ *     +inf so that padding never dominates a sample
+ */
+struct Front
+{
+    QVector< double > columns;
+    QVector< double > ideal;
+    int dimension;
+    int size;
+    int padded_size;
+};
+
+struct Chunk
+{
+    const Front *front;
+    const QVector< Front > *parts;
+    const QVector< double > *reference;
+    quint64 seed;
+    qint64 hits;
+    QVector< qint64 > part_hits;
+};
+
+bool dominatedScalar(const Front &front, const double *sample)
+{
+    for (int i = 0; i < front.size; i++) {
+        int k = 0;
+        while ((k < front.dimension) && (front.columns[k * front.padded_size + i] <= sample[k])) {
+            k++;
+        }
+        if (k == front.dimension) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef HV_AVX2_KERNEL
+/*
+ *     Four front points per register; a block is dropped as soon as none of
+ *     its points can still dominate the sample
+ */
+__attribute__((target("avx2")))
+bool dominatedAVX2(const Front &front, const double *sample)
+{
+    const double *columns = front.columns.constData();
+    const __m256d all_set = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    for (int i = 0; i < front.padded_size; i += 4) {
+        __m256d mask = all_set;
+        int k;
+        for (k = 0; k < front.dimension; k++) {
+            const __m256d p = _mm256_loadu_pd(columns + k * front.padded_size + i);
+            mask = _mm256_and_pd(mask, _mm256_cmp_pd(p, _mm256_set1_pd(sample[k]), _CMP_LE_OQ));
+            if (_mm256_testz_pd(mask, mask)) break;
+        }
+        if (k == front.dimension) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+bool useAVX2()
+{
+#ifdef HV_AVX2_KERNEL
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool dominated(const Front &front, const double *sample)
+{
+    if (useAVX2()) {
+#ifdef HV_AVX2_KERNEL
+        return dominatedAVX2(front, sample);
+#endif
+    }
+    return dominatedScalar(front, sample);
+}
+
+/*
+ *     Count the samples the union dominates, and among them the ones each
+ *     part dominates; a sample outside the union is outside every part
+ */
+void runChunk(Chunk &chunk)
+{
+    const Front &front = *chunk.front;
+    const QVector< double > &reference = *chunk.reference;
+
+    quint64 state = chunk.seed;
+    QVector< double > samples(chunk_samples * front.dimension);
+    for (int s = 0; s < chunk_samples; s++) {
+        for (int k = 0; k < front.dimension; k++) {
+            const double u = (Random::splitMix64(state) >> 11) * (1.0 / 9007199254740992.0);
+            samples[s * front.dimension + k] = front.ideal[k] + u * (reference[k] - front.ideal[k]);
+        }
+    }
+
+    chunk.hits = 0;
+    chunk.part_hits.fill(0, chunk.parts->size());
+    for (int s = 0; s < chunk_samples; s++) {
+        const double *sample = samples.constData() + s * front.dimension;
+        if (!dominated(front, sample)) continue;
+
+        chunk.hits++;
+        for (int p = 0; p < chunk.parts->size(); p++) {
+            if (dominated(chunk.parts->at(p), sample)) {
+                chunk.part_hits[p]++;
+            }
+        }
+    }
+}
+
+/*
+ *     Non-dominated points of a front that dominate the reference point, in
+ *     column-major order
+ */
+Front makeFront(const QVector< double > &points, int dimension, const QVector< double > &reference)
+{
+    QVector< double > inside;
+    for (int i = 0; i + dimension <= points.size(); i += dimension) {
+        bool keep = true;
+        for (int k = 0; k < dimension; k++) {
+            keep = keep && (points[i + k] < reference[k]);
+        }
+        if (keep) {
+            inside += points.mid(i, dimension);
+        }
+    }
+    inside = Hypervolume::nonDominated(inside, dimension);
+
+    Front front;
+    front.dimension = dimension;
+    front.size = inside.size() / dimension;
+    front.padded_size = (front.size + 3) / 4 * 4;
+    front.columns.fill(qInf(), dimension * front.padded_size);
+    front.ideal = inside.mid(0, dimension);
+    for (int i = 0; i < front.size; i++) {
+        for (int k = 0; k < dimension; k++) {
+            front.columns[k * front.padded_size + i] = inside[i * dimension + k];
+            front.ideal[k] = qMin(front.ideal[k], inside[i * dimension + k]);
+        }
+    }
+    return front;
+}
+
+/*
+ *     Two-sided standard normal quantile, by bisection on erf
+ */
+double normalQuantile(double confidence)
+{
+    double low = 0.0;
+    double high = 10.0;
+    for (int i = 0; i < 64; i++) {
+        const double mid = (low + high) / 2;
+        if (erf(mid / sqrt(2.0)) < confidence) low = mid;
+        else high = mid;
+    }
+    return (low + high) / 2;
+}
+
+/*
+ *     Agresti-Coull interval of a fraction of hits in `trials`; returns
+ *     the half-width
+ */
+double interval(qint64 hits, qint64 trials, double z, double *lower, double *upper)
+{
+    const double n = double(trials) + z * z;
+    const double p = (double(hits) + z * z / 2) / n;
+    const double half_width = z * sqrt(p * (1.0 - p) / n);
+
+    *lower = qMax(0.0, p - half_width);
+    *upper = qMin(1.0, p + half_width);
+    return half_width;
+}
+
+/*
+ *     Sample the box of the union until it and every part that is not
+ *     empty reach the accuracy
+ */
+HypervolumeEstimator::Comparison sample(const QVector< double > &points, const QVector< QVector< double > > &part_points, int dimension,
+                                        const QVector< double > &reference, double accuracy, quint64 seed,
+                                        const QAtomicInt *cancelled, double confidence, qint64 max_samples)
+{
+    const HypervolumeEstimator::Estimate none = { 0.0, 0.0, 0.0, 0.0, 0 };
+    const HypervolumeEstimator::Share no_share = { 0.0, 0.0, 0.0 };
+
+    HypervolumeEstimator::Comparison result;
+    result.total = none;
+    result.fronts.fill(none, part_points.size());
+    result.shares.fill(no_share, part_points.size());
+    if ((dimension < 1) || (reference.size() != dimension)) {
+        return result;
+    }
+
+    // Only points dominating the reference point matter
+    const Front front = makeFront(points, dimension, reference);
+    if (front.size == 0) {
+        return result;
+    }
+    QVector< Front > parts;
+    for (int p = 0; p < part_points.size(); p++) {
+        parts.append(makeFront(part_points[p], dimension, reference));
+    }
+
+    double box_volume = 1.0;
+    for (int k = 0; k < dimension; k++) {
+        box_volume *= reference[k] - front.ideal[k];
+    }
+
+    const double z = normalQuantile(confidence);
+    qint64 samples = 0;
+    qint64 hits = 0;
+    QVector< qint64 > part_hits(parts.size(), 0);
+    int round = 0;
+    while ((samples < max_samples) && !(cancelled && cancelled->loadAcquire())) {
+        QVector< Chunk > chunks(round_chunks);
+        for (int c = 0; c < chunks.size(); c++) {
+            quint64 state = seed ^ (0xD1B54A32D192ED03ULL * quint64(round * round_chunks + c + 1));
+            chunks[c].front = &front;
+            chunks[c].parts = &parts;
+            chunks[c].reference = &reference;
+            chunks[c].seed = Random::splitMix64(state);
+            chunks[c].hits = 0;
+        }
+        QtConcurrent::blockingMap(chunks, runChunk);
+
+        for (int c = 0; c < chunks.size(); c++) {
+            hits += chunks[c].hits;
+            for (int p = 0; p < parts.size(); p++) {
+                part_hits[p] += chunks[c].part_hits[p];
+            }
+        }
+        samples += qint64(round_chunks) * chunk_samples;
+        round++;
+
+        double lower, upper;
+        const double half_width = interval(hits, samples, z, &lower, &upper);
+        result.total.value = box_volume * double(hits) / double(samples);
+        result.total.lower = box_volume * lower;
+        result.total.upper = box_volume * upper;
+        result.total.box_volume = box_volume;
+        result.total.samples = samples;
+        bool done = (box_volume * half_width <= accuracy * result.total.value);
+
+        for (int p = 0; p < parts.size(); p++) {
+            if (parts[p].size == 0) continue;
+
+            HypervolumeEstimator::Estimate &estimate = result.fronts[p];
+            const double part_half_width = interval(part_hits[p], samples, z, &lower, &upper);
+            estimate.value = box_volume * double(part_hits[p]) / double(samples);
+            estimate.lower = box_volume * lower;
+            estimate.upper = box_volume * upper;
+            estimate.box_volume = box_volume;
+            estimate.samples = samples;
+            done = done && (box_volume * part_half_width <= accuracy * estimate.value);
+
+            if (hits > 0) {
+                HypervolumeEstimator::Share &share = result.shares[p];
+                interval(part_hits[p], hits, z, &share.lower, &share.upper);
+                share.value = double(part_hits[p]) / double(hits);
+            }
+        }
+
+        if (done) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+}
+
+HypervolumeEstimator::Estimate HypervolumeEstimator::estimate(const QVector< double > &points, int dimension, const QVector< double > &reference,
+                                                              double accuracy, quint64 seed, double confidence, qint64 max_samples)
+{
+    return sample(points, QVector< QVector< double > >(), dimension, reference, accuracy, seed, 0, confidence, max_samples).total;
+}
+
+HypervolumeEstimator::Comparison HypervolumeEstimator::compare(const QVector< QVector< double > > &fronts, int dimension, const QVector< double > &reference,
+                                                               double accuracy, quint64 seed, MetricTask::CancelToken cancelled,
+                                                               double confidence, qint64 max_samples)
+{
+    QVector< double > points;
+    for (int p = 0; p < fronts.size(); p++) {
+        points += fronts[p];
+    }
+
+    return sample(points, fronts, dimension, reference, accuracy, seed, cancelled.data(), confidence, max_samples);
+}
@@ -0,0 +1,61 @@
+#ifndef HVESTIMATOR_H
+#define HVESTIMATOR_H
+
+#include <QVector>
+#include <QtGlobal>
+
+#include "metrictask.h"
+
+/*
+ *     Monte Carlo hypervolume for fronts with many objectives
+ *
+ *     Samples are drawn uniformly in the box between the ideal point of the
+ *     front and the reference point, and the dominated fraction is scaled
+ *     by the box volume. Sampling runs in fixed-size chunks on the thread
+ *     pool, each chunk seeded from (seed, chunk number), so the result
+ *     depends only on the inputs and the seed, never on the thread count.
+ *     Rounds of chunks run until the confidence interval half-width is
+ *     within `accuracy` of the estimate, or `max_samples` is reached.
+ *
+ *     compare() estimates several fronts and their union from the same
+ *     samples, drawn in the box of the union. A sample dominated by a
+ *     front is dominated by the union, so the share of a front is the
+ *     fraction of the samples dominated by the union that it dominates
+ *     too, and its interval is that of a binomial fraction. Once the
+ *     token is set it stops after the current round.
+ */
+namespace HypervolumeEstimator {
+
+struct Estimate
+{
+    double value;
+    double lower;
+    double upper;
+    double box_volume;
+    qint64 samples;
+};
+
+struct Share
+{
+    double value;
+    double lower;
+    double upper;
+};
+
+struct Comparison
+{
+    Estimate total;
+    QVector< Estimate > fronts;
+    QVector< Share > shares;
+};
+
+Estimate estimate(const QVector< double > &points, int dimension, const QVector< double > &reference,
+                  double accuracy, quint64 seed, double confidence = 0.95, qint64 max_samples = 1 << 24);
+
+Comparison compare(const QVector< QVector< double > > &fronts, int dimension, const QVector< double > &reference,
+                   double accuracy, quint64 seed, MetricTask::CancelToken cancelled,
+                   double confidence = 0.95, qint64 max_samples = 1 << 24);
+
+}
+
+#endif // HVESTIMATOR_H
@@ -0,0 +1,470 @@
+#include "hypervolume.h"
+
+#include <QtGlobal>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <map>
+
+namespace {
+
+typedef std::map< double, double > Staircase;
+
+struct PointOrder
+{
+    const double *points;
+    int dimension;
+    int axis;
+
+    bool operator()(int a, int b) const
+    {
+        return points[a * dimension + axis] > points[b * dimension + axis];
+    }
+};
+
+/*
+ *     Lexicographic order of N-D points, ties kept in input order
+ */
+struct LexicographicOrder
+{
+    const double *points;
+    int dimension;
+
+    bool operator()(int a, int b) const
+    {
+        const double *p = points + a * dimension;
+        const double *q = points + b * dimension;
+        for (int k = 0; k < dimension; k++) {
+            if (p[k] < q[k]) return true;
+            if (q[k] < p[k]) return false;
+        }
+        return a < b;
+    }
+};
+
+struct FrontTask
+{
+    const QVector< double > *points;
+    int dimension;
+    QVector< double > front;
+};
+
+void runFrontTask(FrontTask &task)
+{
+    task.front = Hypervolume::nonDominated(*task.points, task.dimension);
+}
+
+bool lessXY(const QPointF &a, const QPointF &b)
+{
+    return (a.x() < b.x()) || ((a.x() == b.x()) && (a.y() < b.y()));
+}
+
+/*
+ *     Keep only the points strictly dominating the reference point
+ */
+QVector< double > clipToReference(const QVector< double > &points, int dimension, const QVector< double > &reference)
+{
+    QVector< double > clipped;
+    clipped.reserve(points.size());
+
+    for (int i = 0; i + dimension <= points.size(); i += dimension) {
+        bool inside = true;
+        for (int k = 0; k < dimension; k++) {
+            if (!(points[i + k] < reference[k])) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) {
+            for (int k = 0; k < dimension; k++) {
+                clipped.append(points[i + k]);
+            }
+        }
+    }
+
+    return clipped;
+}
+
+/*
+ *     Insert (x, y) into a 2-D staircase bounded by the reference point and
+ *     return the area it adds; points it dominates are removed
+ */
+double insertStaircase(Staircase &staircase, double x, double y, double reference_x, double reference_y)
+{
+    Staircase::iterator next = staircase.lower_bound(x);
+
+    if ((next != staircase.end()) && (next->first == x) && (next->second <= y)) {
+        return 0.0;
+    }
+
+    double y_bound = reference_y;
+    if (next != staircase.begin()) {
+        Staircase::iterator prev = next;
+        --prev;
+        if (prev->second <= y) {
+            return 0.0;
+        }
+        y_bound = prev->second;
+    }
+
+    double area = 0.0;
+    double x_left = x;
+    double y_top = y_bound;
+    while ((next != staircase.end()) && (next->second >= y)) {
+        area += (next->first - x_left) * (y_top - y);
+        x_left = next->first;
+        y_top = next->second;
+        next = staircase.erase(next);
+    }
+    const double x_right = (next != staircase.end()) ? next->first : reference_x;
+    area += (x_right - x_left) * (y_top - y);
+
+    staircase[x] = y;
+    return area;
+}
+
+double compute2D(QVector< QPointF > points, const QPointF &reference)
+{
+    std::sort(points.begin(), points.end(), lessXY);
+
+    double hypervolume = 0.0;
+    double y_top = reference.y();
+    for (int i = 0; i < points.size(); i++) {
+        if (points[i].y() < y_top) {
+            hypervolume += (reference.x() - points[i].x()) * (y_top - points[i].y());
+            y_top = points[i].y();
+        }
+    }
+
+    return hypervolume;
+}
+
+/*
+ *     3-D sweep along z keeping the dominated area of the (x, y) staircase
+ */
+double compute3D(const QVector< double > &points, const QVector< double > &reference)
+{
+    const int n = points.size() / 3;
+    QVector< int > order(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    PointOrder by_z = { points.constData(), 3, 2 };
+    std::sort(order.begin(), order.end(), by_z);
+    std::reverse(order.begin(), order.end());
+
+    Staircase staircase;
+    double area = 0.0;
+    double hypervolume = 0.0;
+    for (int i = 0; i < n; i++) {
+        const double *p = points.constData() + order[i] * 3;
+        area += insertStaircase(staircase, p[0], p[1], reference[0], reference[1]);
+
+        const double z_next = (i + 1 < n) ? points[order[i + 1] * 3 + 2] : reference[2];
+        hypervolume += area * (z_next - p[2]);
+    }
+
+    return hypervolume;
+}
+
+/*
+ *     WFG: sum of exclusive contributions, points sorted by decreasing last
+ *     objective so every limit set lies in a slice one dimension lower
+ */
+double computeWFG(const QVector< double > &points, int dimension, const QVector< double > &reference)
+{
+    const int n = points.size() / dimension;
+    if (n == 0) {
+        return 0.0;
+    }
+    if (dimension == 2) {
+        QVector< QPointF > points_2d(n);
+        for (int i = 0; i < n; i++) points_2d[i] = QPointF(points[2 * i], points[2 * i + 1]);
+        return compute2D(points_2d, QPointF(reference[0], reference[1]));
+    }
+    if (dimension == 3) {
+        return compute3D(points, reference);
+    }
+
+    const int last = dimension - 1;
+    QVector< int > order(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    PointOrder by_last = { points.constData(), dimension, last };
+    std::sort(order.begin(), order.end(), by_last);
+
+    const QVector< double > reference_slice = reference.mid(0, last);
+
+    double hypervolume = 0.0;
+    for (int i = 0; i < n; i++) {
+        const double *p = points.constData() + order[i] * dimension;
+
+        double inclusive = 1.0;
+        for (int k = 0; k < last; k++) {
+            inclusive *= reference[k] - p[k];
+        }
+
+        QVector< double > limit_set;
+        limit_set.reserve((n - i - 1) * last);
+        for (int j = i + 1; j < n; j++) {
+            const double *q = points.constData() + order[j] * dimension;
+            for (int k = 0; k < last; k++) {
+                limit_set.append(qMax(p[k], q[k]));
+            }
+        }
+
+        const double exclusive = inclusive - computeWFG(Hypervolume::nonDominated(limit_set, last), last, reference_slice);
+        hypervolume += (reference[last] - p[last]) * exclusive;
+    }
+
+    return hypervolume;
+}
+
+}
+
+/*
+ *     Hypervolume of an N-D point set
+ */
+double Hypervolume::compute(const QVector< double > &points, int dimension, const QVector< double > &reference)
+{
+    if ((dimension < 1) || (reference.size() != dimension)) {
+        return 0.0;
+    }
+
+    QVector< double > clipped = clipToReference(points, dimension, reference);
+    if (clipped.isEmpty()) {
+        return 0.0;
+    }
+
+    if (dimension == 1) {
+        return reference[0] - *std::min_element(clipped.constBegin(), clipped.constEnd());
+    }
+    if (dimension <= 3) {
+        return computeWFG(clipped, dimension, reference);
+    }
+    return computeWFG(Hypervolume::nonDominated(clipped, dimension), dimension, reference);
+}
+
+/*
+ *     Hypervolume of a 2-D point set
+ */
+double Hypervolume::compute(const QVector< QPointF > &points, const QPointF &reference)
+{
+    QVector< QPointF > clipped;
+    for (int i = 0; i < points.size(); i++) {
+        if ((points[i].x() < reference.x()) && (points[i].y() < reference.y())) {
+            clipped.append(points[i]);
+        }
+    }
+
+    return compute2D(clipped, reference);
+}
+
+/*
+ *     Remove dominated and duplicated points
+ *
+ *     A point can only be dominated by, or equal to, a point that comes
+ *     before it in lexicographic order, so after sorting each point is
+ *     compared with the front found so far only: O(n log n + n f) for a
+ *     front of f points. Points stay in input order, the first of equal
+ *     points is kept.
+ */
+QVector< double > Hypervolume::nonDominated(const QVector< double > &points, int dimension)
+{
+    const int n = points.size() / dimension;
+    QVector< int > order(n);
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    LexicographicOrder lexicographic = { points.constData(), dimension };
+    std::sort(order.begin(), order.end(), lexicographic);
+
+    QVector< int > kept;
+    for (int i = 0; i < n; i++) {
+        const double *p = points.constData() + order[i] * dimension;
+
+        bool dominated = false;
+        for (int j = 0; (j < kept.size()) && !dominated; j++) {
+            const double *q = points.constData() + kept[j] * dimension;
+
+            // q is not worse in any objective, so it dominates or equals p
+            dominated = true;
+            for (int k = 0; k < dimension; k++) {
+                if (p[k] < q[k]) {
+                    dominated = false;
+                    break;
+                }
+            }
+        }
+
+        if (!dominated) {
+            kept.append(order[i]);
+        }
+    }
+    std::sort(kept.begin(), kept.end());
+
+    QVector< double > front;
+    front.reserve(kept.size() * dimension);
+    for (int i = 0; i < kept.size(); i++) {
+        for (int k = 0; k < dimension; k++) {
+            front.append(points[kept[i] * dimension + k]);
+        }
+    }
+
+    return front;
+}
+
+/*
+ *     Remove dominated points of every set concurrently, one task per set
+ */
+QVector< QVector< double > > Hypervolume::nonDominatedAll(const QVector< QVector< double > > &point_sets, int dimension)
+{
+    QVector< FrontTask > tasks(point_sets.size());
+    for (int i = 0; i < point_sets.size(); i++) {
+        tasks[i].points = &point_sets[i];
+        tasks[i].dimension = dimension;
+    }
+    QtConcurrent::blockingMap(tasks, runFrontTask);
+
+    QVector< QVector< double > > fronts(point_sets.size());
+    for (int i = 0; i < tasks.size(); i++) {
+        fronts[i] = tasks[i].front;
+    }
+
+    return fronts;
+}
+
+/*
+ *     Nadir point of a set, pushed out by a margin relative to its range
+ */
+QVector< double > Hypervolume::nadirReference(const QVector< double > &points, int dimension, double margin)
+{
+    QVector< double > reference(dimension, 0.0);
+    if (points.size() < dimension) {
+        return reference;
+    }
+
+    for (int k = 0; k < dimension; k++) {
+        double nadir = points[k];
+        double ideal = points[k];
+        for (int i = dimension + k; i < points.size(); i += dimension) {
+            nadir = qMax(nadir, points[i]);
+            ideal = qMin(ideal, points[i]);
+        }
+
+        double span = nadir - ideal;
+        if (span <= 0.0) {
+            span = qMax(qAbs(nadir), 1.0);
+        }
+        reference[k] = nadir + margin * span;
+    }
+
+    return reference;
+}
+
+QPointF Hypervolume::nadirReference(const QVector< QPointF > &points, double margin)
+{
+    QVector< double > flat;
+    flat.reserve(2 * points.size());
+    for (int i = 0; i < points.size(); i++) {
+        flat << points[i].x() << points[i].y();
+    }
+
+    QVector< double > reference = nadirReference(flat, 2, margin);
+    return QPointF(reference[0], reference[1]);
+}
+
+IncrementalHypervolume::IncrementalHypervolume(int dimension) :
+    dimension(dimension),
+    hypervolume(0.0),
+    reference_point(dimension, 0.0)
+{
+}
+
+void IncrementalHypervolume::reset(const QVector< double > &reference)
+{
+    reference_point = reference;
+    hypervolume = 0.0;
+    staircase.clear();
+    front.clear();
+}
+
+void IncrementalHypervolume::reset(const QPointF &reference)
+{
+    QVector< double > reference_2d;
+    reference_2d << reference.x() << reference.y();
+    reset(reference_2d);
+}
+
+/*
+ *     Add one point and return the volume it adds
+ */
+double IncrementalHypervolume::insert(const double *point)
+{
+    for (int k = 0; k < dimension; k++) {
+        if (!(point[k] < reference_point[k])) {
+            return 0.0;
+        }
+    }
+
+    double gain;
+    if (dimension == 2) {
+        gain = insertStaircase(staircase, point[0], point[1], reference_point[0], reference_point[1]);
+    }
+    else {
+        const int n = front.size() / dimension;
+
+        QVector< double > limit_set;
+        limit_set.reserve(front.size());
+        for (int i = 0; i < n; i++) {
+            const double *q = front.constData() + i * dimension;
+
+            bool q_dominates = true;
+            for (int k = 0; k < dimension; k++) {
+                if (q[k] > point[k]) {
+                    q_dominates = false;
+                }
+                limit_set.append(qMax(point[k], q[k]));
+            }
+            if (q_dominates) {
+                return 0.0;
+            }
+        }
+
+        double inclusive = 1.0;
+        for (int k = 0; k < dimension; k++) {
+            inclusive *= reference_point[k] - point[k];
+        }
+        gain = inclusive - Hypervolume::compute(limit_set, dimension, reference_point);
+
+        // evict the front points the new one dominates
+        QVector< double > kept;
+        kept.reserve(front.size() + dimension);
+        for (int i = 0; i < n; i++) {
+            const double *q = front.constData() + i * dimension;
+
+            bool dominated = true;
+            for (int k = 0; k < dimension; k++) {
+                if (point[k] > q[k]) {
+                    dominated = false;
+                    break;
+                }
+            }
+            if (!dominated) {
+                for (int k = 0; k < dimension; k++) {
+                    kept.append(q[k]);
+                }
+            }
+        }
+        for (int k = 0; k < dimension; k++) {
+            kept.append(point[k]);
+        }
+        front = kept;
+    }
+
+    hypervolume += gain;
+    return gain;
+}
+
+double IncrementalHypervolume::insert(const QPointF &point)
+{
+    const double point_2d[2] = { point.x(), point.y() };
+    return insert(point_2d);
+}
@@ -0,0 +1,68 @@
+#ifndef HYPERVOLUME_H
+#define HYPERVOLUME_H
+
+#include <QVector>
+#include <QPointF>
+
+#include <map>
+
+/*
+ *     Exact hypervolume of a point set, all objectives minimized
+ *
+ *     N-D points are stored row-major in a flat array, `dimension` values
+ *     per point. Points that do not strictly dominate the reference point
+ *     contribute nothing. 2-D and 3-D use O(n log n) sweeps, higher
+ *     dimensions the WFG algorithm.
+ */
+namespace Hypervolume {
+
+double compute(const QVector< double > &points, int dimension, const QVector< double > &reference);
+
+double compute(const QVector< QPointF > &points, const QPointF &reference);
+
+QVector< double > nonDominated(const QVector< double > &points, int dimension);
+
+QVector< QVector< double > > nonDominatedAll(const QVector< QVector< double > > &point_sets, int dimension);
+
+QVector< double > nadirReference(const QVector< double > &points, int dimension, double margin);
+
+QPointF nadirReference(const QVector< QPointF > &points, double margin);
+
+}
+
+/*
+ *     Hypervolume of a front that grows one point at a time
+ *
+ *     Each insert only adds the exclusive volume of the new point; points it
+ *     dominates are evicted without changing the value. 2-D fronts are kept
+ *     as a staircase, so an insert costs O(log n) plus the evicted points.
+ *     Higher dimensions subtract the hypervolume of the limit set from the
+ *     box of the new point. Changing the reference point needs a reset.
+ */
+class IncrementalHypervolume
+{
+public:
+    explicit IncrementalHypervolume(int dimension = 2);
+
+    void reset(const QVector< double > &reference);
+
+    void reset(const QPointF &reference);
+
+    double insert(const double *point);
+
+    double insert(const QPointF &point);
+
+    double value() const { return hypervolume; }
+
+    const QVector< double > &reference() const { return reference_point; }
+
+private:
+    int dimension;
+    double hypervolume;
+    QVector< double > reference_point;
+
+    std::map< double, double > staircase;
+    QVector< double > front;
+};
+
+#endif // HYPERVOLUME_H
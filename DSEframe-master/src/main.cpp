@@ -1,9 +1,20 @@
 #include "mainwindow.h"
+#include "batchreport.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    // Reports are rendered without a window, on the offscreen platform
+    const bool batch_report = BatchReport::requested(argc, argv);
+    if (batch_report && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication a(argc, argv);
+    if (batch_report) {
+        return BatchReport::run(a.arguments());
+    }
+
     MainWindow w;
     w.show();
 
@@ -4,6 +4,7 @@
 #include "aboutwindow.h"
 #include "helpwindow.h"
 #include "newfile.h"
+#include "frontmetrics.h"
 
 #include <QFile>
 #include <QTextStream>
@@ -11,13 +12,61 @@
 #include <QtCore>
 #include <QtGui>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QThread>
 #include <QFileSystemWatcher>
+#include <QHeaderView>
+#include <QToolTip>
+#include <QtConcurrent>
+
+#include <algorithm>
 
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+namespace {
+
+/*
+ *     Monte Carlo hypervolume of the checked groups over the objective
+ *     columns, run off the GUI thread on a copy of the store
+ */
+struct HyperVolumeTask
+{
+    DesignStore designs;
+    QVector< bool > checked;
+    QVector< int > objectives;
+    double margin;
+    double accuracy;
+    quint64 seed;
+    MetricTask::CancelToken cancelled;
+};
+
+HypervolumeEstimator::Comparison runHyperVolumeTask(HyperVolumeTask task)
+{
+    const int dimension = task.objectives.size();
+
+    // Group fronts are built on the pool; only their union is filtered here
+    QVector< QVector< double > > group_points(task.checked.size());
+    for (int i = 0; i < task.checked.size(); i++) {
+        if (task.checked[i]) {
+            group_points[i] = task.designs.groupPoints(i, task.objectives);
+        }
+    }
+    const QVector< QVector< double > > fronts = Hypervolume::nonDominatedAll(group_points, dimension);
+
+    QVector< double > front_all;
+    for (int i = 0; i < fronts.size(); i++) {
+        front_all += fronts[i];
+    }
+    front_all = Hypervolume::nonDominated(front_all, dimension);
+
+    const QVector< double > reference = Hypervolume::nadirReference(front_all, dimension, task.margin);
+    return HypervolumeEstimator::compare(fronts, dimension, reference, task.accuracy, task.seed, task.cancelled);
+}
+
+}
+
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::MainWindow)
@@ -29,12 +78,130 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(watcher, SIGNAL(fileChanged(const QString & )),
             this,    SLOT(updateData(const QString & )));
 
+    metric_cancel = MetricTask::CancelToken(new QAtomicInt(0));
+    metric_watcher = new QFutureWatcher< QVector< MetricTask::Job > >(this);
+    connect(metric_watcher, SIGNAL(finished()), this, SLOT(metricsFinished()));
+
+    bootstrap_cancel = MetricTask::CancelToken(new QAtomicInt(0));
+    bootstrap_watcher = new QFutureWatcher< QVector< Bootstrap::Summary > >(this);
+    connect(bootstrap_watcher, SIGNAL(finished()), this, SLOT(bootstrapFinished()));
+
+    hv_estimate_cancel = MetricTask::CancelToken(new QAtomicInt(0));
+    hv_estimate_watcher = new QFutureWatcher< HypervolumeEstimator::Comparison >(this);
+    connect(hv_estimate_watcher, SIGNAL(finished()), this, SLOT(hyperVolumeEstimated()));
+
+    anytime_pending = false;
+    anytime_cancel = MetricTask::CancelToken(new QAtomicInt(0));
+    anytime_watcher = new QFutureWatcher< QVector< AnytimeCurve > >(this);
+    connect(anytime_watcher, SIGNAL(finished()), this, SLOT(anytimeFinished()));
+
+    pyramid_watcher = new QFutureWatcher< QVector< QSharedPointer< const PointPyramid > > >(this);
+    connect(pyramid_watcher, SIGNAL(finished()), this, SLOT(pyramidsFinished()));
+    pyramid_generation = 0;
+    pyramid_launch_generation = 0;
+    data_generation = 0;
+
+    // Density, rows, rows appended since the last full replot and fronts each
+    // get their own paint buffer, so streaming only repaints what changed
+    QCustomPlot *plot = ui->dataPlot;
+    plot->addLayer("density", plot->layer("main"), QCustomPlot::limBelow);
+    plot->addLayer("data", plot->layer("main"), QCustomPlot::limBelow);
+    plot->addLayer("increment", plot->layer("main"), QCustomPlot::limBelow);
+    plot->addLayer("fronts", plot->layer("main"), QCustomPlot::limAbove);
+    plot->addLayer("selection", plot->layer("fronts"), QCustomPlot::limAbove);
+    plot->layer("density")->setMode(QCPLayer::lmBuffered);
+    plot->layer("data")->setMode(QCPLayer::lmBuffered);
+    plot->layer("increment")->setMode(QCPLayer::lmBuffered);
+    plot->layer("fronts")->setMode(QCPLayer::lmBuffered);
+    plot->layer("selection")->setMode(QCPLayer::lmBuffered);
+    group_legend = new GroupLegendItem(plot->legend);
+    plot->legend->addItem(group_legend);
+    graph_x_max = 0.0;
+    graph_y_max = 0.0;
+    graph_generation = 0;
+
+    // Redraws requested during one frame are merged into a single replot
+    frame_timer = new QTimer(this);
+    frame_timer->setSingleShot(true);
+    connect(frame_timer, SIGNAL(timeout()), this, SLOT(updateGraph()));
+    const qreal refresh_rate = QGuiApplication::primaryScreen()->refreshRate();
+    frame_interval = (refresh_rate > 0) ? qMax(1, qRound(1000.0 / refresh_rate)) : 16;
+    frame_clock.start();
+    scatter_skip = 0;
+
+    // Zooming or dragging the view rebins the density at most once a frame
+    density_timer = new QTimer(this);
+    density_timer->setSingleShot(true);
+    connect(density_timer, SIGNAL(timeout()), this, SLOT(refreshDensity()));
+
+    // Streamed rows reach the design views at most once a frame
+    design_timer = new QTimer(this);
+    design_timer->setSingleShot(true);
+    connect(design_timer, SIGNAL(timeout()), this, SLOT(updateDesignViews()));
+    connect(ui->dataPlot->xAxis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(densityRangeChanged()));
+    connect(ui->dataPlot->yAxis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(densityRangeChanged()));
+
+    // Hover and click find the design under the cursor in pixel space
+    connect(plot, SIGNAL(afterReplot()), this, SLOT(invalidatePickIndex()));
+    connect(plot, SIGNAL(mouseMove(QMouseEvent*)), this, SLOT(plotMouseMove(QMouseEvent*)));
+    connect(plot, SIGNAL(mousePress(QMouseEvent*)), this, SLOT(plotMousePress(QMouseEvent*)));
+    connect(plot, SIGNAL(mouseRelease(QMouseEvent*)), this, SLOT(plotMouseRelease(QMouseEvent*)));
+    pick_index_valid = false;
+
+    scatter_matrix = 0;
+    parallel_coordinates = 0;
+
     x_var = "Latency";
     y_var = "AREA";
+    golden_version = 0;
     resetData();
 
     m_sSettingsFile = QApplication::applicationDirPath() + "/settings.ini";
     loadSettings();
+    loadHyperVolumeReference();
+
+    QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+    QStringList indicators = settings.value("indicators").toStringList();
+    for (int k = 0; k < FrontMetrics::IndicatorCount; k++) {
+        QAction *action = ui->menuIndicators->addAction(FrontMetrics::indicatorName(k));
+        action->setCheckable(true);
+        action->setChecked(indicators.contains(FrontMetrics::indicatorName(k)));
+        connect(action, SIGNAL(toggled(bool)), this, SLOT(indicatorToggled()));
+        indicator_actions.append(action);
+    }
+
+    for (int m = 0; m < AnytimeCurves::MetricCount; m++) {
+        ui->anytimeMetricList->addItem(AnytimeCurves::metricName(m));
+    }
+    // The saved state is restored without writing it back
+    {
+        const QSignalBlocker stride_blocker(ui->anytimeStrideSpin);
+        const QSignalBlocker curves_blocker(ui->actionAnytime_Curves);
+        ui->anytimeStrideSpin->setValue(settings.value("anytimeStride", 1).toInt());
+        ui->actionAnytime_Curves->setChecked(settings.value("anytimeCurves", false).toBool());
+    }
+    ui->anytimePanel->setVisible(ui->actionAnytime_Curves->isChecked());
+
+    // Front points can be sized by their hypervolume contribution or crowding distance
+    point_size_mode = settings.value("pointSize", 0).toInt();
+    point_size_group = new QActionGroup(this);
+    QStringList point_sizes;
+    point_sizes << "Fixed" << "HV Contribution" << "Crowding";
+    for (int k = 0; k < point_sizes.size(); k++) {
+        QAction *action = ui->menuPointSize->addAction(point_sizes.at(k));
+        action->setCheckable(true);
+        action->setChecked(k == point_size_mode);
+        action->setData(k);
+        point_size_group->addAction(action);
+    }
+    connect(point_size_group, SIGNAL(triggered(QAction*)), this, SLOT(pointSizeTriggered(QAction*)));
+
+    // A header click sorts the designs of each method; the methods and
+    // their summaries keep the order the plot colors follow
+    ui->dataTreeWidget->header()->setSortIndicator(-1, Qt::AscendingOrder);
+    ui->dataTreeWidget->header()->setSortIndicatorShown(true);
+    ui->dataTreeWidget->header()->setSectionsClickable(true);
+    connect(ui->dataTreeWidget->header(), SIGNAL(sortIndicatorChanged(int,Qt::SortOrder)), this, SLOT(dataSortChanged()));
 }
 
 MainWindow::~MainWindow()
@@ -43,6 +210,16 @@ MainWindow::~MainWindow()
         on_stopButton_clicked();
     }
 
+    metric_cancel->fetchAndStoreRelaxed(1);
+    metric_watcher->waitForFinished();
+    bootstrap_cancel->fetchAndStoreRelaxed(1);
+    bootstrap_watcher->waitForFinished();
+    hv_estimate_cancel->fetchAndStoreRelaxed(1);
+    hv_estimate_watcher->waitForFinished();
+    anytime_cancel->fetchAndStoreRelaxed(1);
+    anytime_watcher->waitForFinished();
+    pyramid_watcher->waitForFinished();
+
     delete ui;
 }
 
@@ -51,6 +228,11 @@ void MainWindow::loadSettings()
     QSettings settings(m_sSettingsFile, QSettings::IniFormat);
     default_path = settings.value("directoryPath", "").toString();
     default_filename = settings.value("fileName", "").toString();
+    hv_margin = settings.value("hvMargin", 0.1).toDouble();
+    hv_accuracy = settings.value("hvAccuracy", 0.01).toDouble();
+    hv_seed = settings.value("hvSeed", 1).toULongLong();
+    bootstrap_resamples = settings.value("bootstrapResamples", 2000).toInt();
+    frame_budget = settings.value("frameBudget", 0).toInt();
 }
 
 void MainWindow::saveSettings()
@@ -58,6 +240,144 @@ void MainWindow::saveSettings()
     QSettings settings(m_sSettingsFile, QSettings::IniFormat);
     settings.setValue("directoryPath", default_path);
     settings.setValue("fileName", default_filename);
+    settings.setValue("hvMargin", hv_margin);
+    settings.setValue("hvAccuracy", hv_accuracy);
+    settings.setValue("hvSeed", hv_seed);
+    settings.setValue("bootstrapResamples", bootstrap_resamples);
+    settings.setValue("frameBudget", frame_budget);
+}
+
+/*
+ *     The hypervolume reference point is kept per axis pair
+ */
+void MainWindow::loadHyperVolumeReference()
+{
+    QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+    ui->hvReferenceLineEdit->setText(settings.value("hvReference/" + x_var + "_" + y_var, "").toString());
+    ui->hvReferenceLineEdit->setPlaceholderText(tr("nadir + %1%").arg(hv_margin * 100.0));
+}
+
+/*
+ *     The typed reference point, or the nadir of the reference front plus
+ *     the margin
+ *
+ *     The default is held while the front stays inside it, so rows streamed
+ *     in do not move it with every new extreme and rebuild every
+ *     hypervolume. Once the nadir reaches it, it is moved out by twice the
+ *     margin; a new selection, front or data set starts from the margin.
+ */
+QPointF MainWindow::hyperVolumeReference()
+{
+    QStringList list = ui->hvReferenceLineEdit->text().split(",", QString::SkipEmptyParts);
+    if (list.size() == 2) {
+        bool x_ok, y_ok;
+        QPointF reference(list.at(0).trimmed().toDouble(&x_ok), list.at(1).trimmed().toDouble(&y_ok));
+        if (x_ok && y_ok) {
+            return reference;
+        }
+    }
+
+    const QVector< QPointF > &front = referenceFront();
+    if (front.isEmpty()) {
+        return Hypervolume::nadirReference(front, hv_margin);
+    }
+
+    const QPointF nadir = Hypervolume::nadirReference(front, 0.0);
+    if (!hv_default_valid || (nadir.x() >= hv_default_reference.x()) || (nadir.y() >= hv_default_reference.y())) {
+        hv_default_reference = Hypervolume::nadirReference(front, hv_default_valid ? 2.0 * hv_margin : hv_margin);
+        hv_default_valid = true;
+    }
+    return hv_default_reference;
+}
+
+/*
+ *     Columns used by the N-D hypervolume, all minimized: the "hvObjectives"
+ *     setting, or every numeric column except Method, Iteration and ATTR
+ */
+QVector< int > MainWindow::hyperVolumeObjectives()
+{
+    QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+    QStringList names = settings.value("hvObjectives").toStringList();
+
+    QVector< int > objectives;
+    for (int i = 0; i < designs.columnCount(); i++) {
+        const QString name = designs.columnNames().at(i);
+        if (!designs.isNumeric(i)) continue;
+
+        if (names.isEmpty()) {
+            if ((name != "Method") && (name != "Iteration") && (name != "ATTR")) {
+                objectives.append(i);
+            }
+        }
+        else if (names.contains(name)) {
+            objectives.append(i);
+        }
+    }
+
+    return objectives;
+}
+
+/*
+ *     Read the golden reference front of the current axes from golden_file
+ *
+ *     The file has the same layout as the data files; only its front is
+ *     kept, which is already the x-sorted array the metrics search.
+ */
+bool MainWindow::loadGoldenFront()
+{
+    golden_front.clear();
+    golden_version++;
+    hv_default_valid = false;
+
+    QFile file(golden_file);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        return false;
+    }
+
+    QTextStream in(&file);
+    QStringList header = in.readLine().split(",", QString::SkipEmptyParts);
+    int x_var_index = header.indexOf(x_var);
+    int y_var_index = header.indexOf(y_var);
+    if ((x_var_index == -1) || (y_var_index == -1)) {
+        return false;
+    }
+
+    QVector< QPointF > points;
+    while (!in.atEnd()) {
+        QStringList list = in.readLine().split(",", QString::SkipEmptyParts);
+        if (list.size() != header.size()) continue;
+
+        bool x_ok, y_ok;
+        QPointF point(list.at(x_var_index).toDouble(&x_ok), list.at(y_var_index).toDouble(&y_ok));
+        if (x_ok && y_ok) {
+            points << point;
+        }
+    }
+    file.close();
+
+    golden_front = ParetoFront::build(points);
+    rebuildHyperVolume(hv_golden, golden_front, hyperVolumeReference());
+
+    return !golden_front.isEmpty();
+}
+
+/*
+ *     Front the methods are scored against: the golden front when one is
+ *     loaded, otherwise the front of the checked methods
+ */
+const QVector< QPointF > &MainWindow::referenceFront() const
+{
+    return golden_front.isEmpty() ? op_points_all.points() : golden_front;
+}
+
+double MainWindow::referenceHyperVolume() const
+{
+    return golden_front.isEmpty() ? hv_all.value() : hv_golden.value();
+}
+
+QColor MainWindow::methodColor(int method_n)
+{
+    return QColor(qSin(method_n*0.6)*100+100, qSin(method_n*1.2+0.7)*100+100, qSin(method_n*0.8+0.6)*100+100);
 }
 
 void MainWindow::on_actionNew_File_triggered()
@@ -87,9 +407,9 @@ void MainWindow::on_actionLoad_File_triggered()
     if (!fileName.isEmpty()) {
         resetData();
 
-        readCsvData(fileName);
+        data_line_cnt = readCsvData(fileName);
         analyseData();
-        updateGraph();
+        scheduleGraph();
 
         default_path = QFileInfo(fileName).path();
         default_filename = QFileInfo(fileName).fileName();
@@ -117,6 +437,212 @@ void MainWindow::on_actionAbout_triggered()
     about_window->exec();
 }
 
+/*
+ *     Monte Carlo hypervolume of every checked method over all objective
+ *     columns, and its share of the hypervolume of the checked methods
+ *     together; both are estimated from the same samples, so the interval
+ *     of the share accounts for the error of the total too
+ *
+ *     The estimate runs on the thread pool and is printed when it
+ *     finishes; starting another one cancels it.
+ */
+void MainWindow::on_actionEstimate_HyperVolume_triggered()
+{
+    QVector< int > objectives = hyperVolumeObjectives();
+    const int dimension = objectives.size();
+    if ((designs.rowCount() == 0) || (dimension == 0)) {
+        QMessageBox::information(this, "N-D HyperVolume", "No numeric objective columns loaded.");
+        return;
+    }
+
+    bool ok;
+    double accuracy = QInputDialog::getDouble(this, tr("N-D HyperVolume"), tr("Relative accuracy target:"),
+                                              hv_accuracy, 0.0001, 1.0, 4, &ok);
+    if (!ok) return;
+    hv_accuracy = accuracy;
+    saveSettings();
+
+    HyperVolumeTask task;
+    task.designs = designs;
+    task.objectives = objectives;
+    task.margin = hv_margin;
+    task.accuracy = accuracy;
+    task.seed = hv_seed;
+    hv_estimate_methods.clear();
+    for (int i = 0; i < itm_parent.size(); i++) {
+        const bool checked = (itm_parent.at(i)->checkState(0) == Qt::Checked);
+        task.checked.append(checked);
+        hv_estimate_methods << (checked ? itm_parent.at(i)->text(0) + " " + itm_parent.at(i)->text(1) : QString());
+    }
+
+    hv_estimate_cancel->fetchAndStoreRelaxed(1);
+    hv_estimate_cancel = MetricTask::CancelToken(new QAtomicInt(0));
+    task.cancelled = hv_estimate_cancel;
+    hv_estimate_watcher->setFuture(QtConcurrent::run(runHyperVolumeTask, task));
+
+    QStringList names;
+    for (int k = 0; k < dimension; k++) {
+        names << designs.columnNames().at(objectives[k]);
+    }
+    ui->consoleText->append(tr("Estimating N-D HyperVolume over %1 (seed %2)...").arg(names.join(", ")).arg(hv_seed));
+}
+
+/*
+ *     Print the estimate of the last run that was not cancelled
+ */
+void MainWindow::hyperVolumeEstimated()
+{
+    if (hv_estimate_cancel->loadAcquire()) return;
+
+    const HypervolumeEstimator::Comparison comparison = hv_estimate_watcher->result();
+    ui->consoleText->append(tr("N-D HyperVolume (%1 samples): %2 (95% CI %3 - %4)")
+                            .arg(comparison.total.samples)
+                            .arg(comparison.total.value, 0, 'g', 6)
+                            .arg(comparison.total.lower, 0, 'g', 6)
+                            .arg(comparison.total.upper, 0, 'g', 6));
+
+    for (int i = 0; i < hv_estimate_methods.size(); i++) {
+        if (hv_estimate_methods.at(i).isEmpty() || (comparison.total.value <= 0.0)) continue;
+
+        const HypervolumeEstimator::Estimate &estimate = comparison.fronts[i];
+        const HypervolumeEstimator::Share &share = comparison.shares[i];
+        ui->consoleText->append(tr("  %1: %2% (95% CI %3% - %4%), HV %5 (95% CI %6 - %7)")
+                                .arg(hv_estimate_methods.at(i))
+                                .arg(share.value * 100.0, 0, 'f', 2)
+                                .arg(share.lower * 100.0, 0, 'f', 2)
+                                .arg(share.upper * 100.0, 0, 'f', 2)
+                                .arg(estimate.value, 0, 'g', 6)
+                                .arg(estimate.lower, 0, 'g', 6)
+                                .arg(estimate.upper, 0, 'g', 6));
+    }
+}
+
+
+void MainWindow::on_actionAnytime_Curves_toggled(bool checked)
+{
+    QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+    settings.setValue("anytimeCurves", checked);
+
+    ui->anytimePanel->setVisible(checked);
+    updateAnytimeCurves();
+}
+
+/*
+ *     Open the scatterplot matrix of the columns chosen last time
+ */
+void MainWindow::on_actionScatter_Matrix_triggered()
+{
+    if (!scatter_matrix) {
+        QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+        QStringList columns;
+        columns << "AREA" << "Latency" << "Pave" << "cp_delay" << "REG" << "FU";
+
+        scatter_matrix = new ScatterMatrix(this);
+        scatter_matrix->setWindowTitle(tr("Scatterplot Matrix"));
+        scatter_matrix->resize(800, 800);
+        scatter_matrix->setColumns(settings.value("matrixColumns", columns).toStringList());
+        connect(scatter_matrix, SIGNAL(columnsChanged(QStringList)), this, SLOT(matrixColumnsChanged(QStringList)));
+    }
+
+    scatter_matrix->show();
+    scatter_matrix->raise();
+    scatter_matrix->activateWindow();
+    updateDesignViews();
+}
+
+/*
+ *     Open the parallel coordinates of all numeric columns
+ */
+void MainWindow::on_actionParallel_Coordinates_triggered()
+{
+    if (!parallel_coordinates) {
+        parallel_coordinates = new ParallelCoordinates(this);
+        parallel_coordinates->setWindowTitle(tr("Parallel Coordinates"));
+        parallel_coordinates->resize(1000, 500);
+    }
+
+    parallel_coordinates->show();
+    parallel_coordinates->raise();
+    parallel_coordinates->activateWindow();
+    updateDesignViews();
+}
+
+/*
+ *     Hand the rows and the checked methods to the open design views
+ *
+ *     The views take a copy of the store, which shares its column blocks,
+ *     and only read the rows appended since their last copy.
+ */
+void MainWindow::updateDesignViews()
+{
+    design_timer->stop();
+
+    const bool matrix_shown = scatter_matrix && scatter_matrix->isVisible();
+    const bool coordinates_shown = parallel_coordinates && parallel_coordinates->isVisible();
+    if (!matrix_shown && !coordinates_shown) {
+        return;
+    }
+
+    QVector< QColor > colors(itm_parent.size());
+    QVector< bool > checked(itm_parent.size());
+    for (int i = 0; i < itm_parent.size(); i++) {
+        colors[i] = methodColor(i);
+        checked[i] = (itm_parent.at(i)->checkState(0) == Qt::Checked);
+    }
+    if (matrix_shown) {
+        scatter_matrix->setDesigns(designs, colors, checked);
+    }
+    if (coordinates_shown) {
+        parallel_coordinates->setDesigns(designs, checked);
+    }
+}
+
+void MainWindow::scheduleDesignViews()
+{
+    if (!design_timer->isActive()) {
+        design_timer->start(frame_interval);
+    }
+}
+
+void MainWindow::matrixColumnsChanged(const QStringList &names)
+{
+    QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+    settings.setValue("matrixColumns", names);
+}
+
+void MainWindow::on_actionLoad_Reference_Front_triggered()
+{
+    QString fileName = QFileDialog::getOpenFileName(this,
+                                                    tr("Open Reference Front"),
+                                                    default_path,
+                                                    tr("CSV File(*.csv);;All Files(*);;Text File(*.txt)"));
+    if (fileName.isEmpty()) return;
+
+    golden_file = fileName;
+    if (!loadGoldenFront()) {
+        QMessageBox::warning(this,
+                             tr("Error occured reading reference front"),
+                             "Cannot find " + x_var + " and " + y_var + " values in " + fileName + ".");
+        on_actionClear_Reference_Front_triggered();
+        return;
+    }
+    ui->consoleText->append(tr("Reference front: %1 (%2 points)").arg(fileName).arg(golden_front.size()));
+
+    analyseData();
+    scheduleGraph();
+}
+
+void MainWindow::on_actionClear_Reference_Front_triggered()
+{
+    golden_file.clear();
+    golden_front.clear();
+    golden_version++;
+    hv_default_valid = false;
+
+    getNewOptimalPoints();
+    analyseData();
+    scheduleGraph();
+}
 
 void MainWindow::on_runButton_clicked()
 {
@@ -198,13 +724,31 @@ void MainWindow::read_cmd_err()
 void MainWindow::resetData()
 {
     data_line_cnt = 0;
+    contribution_column = 0;
 
     ui->dataTreeWidget->clear();
     itm_parent.clear();
+    itm_aggregate.clear();
 
+    designs.clear();
     data_points.clear();
     op_points_local.clear();
+    op_points_local_version.clear();
+    op_points_local_rows.clear();
+    data_items.clear();
     op_points_all.clear();
+    metric_cancel->fetchAndStoreRelaxed(1);
+    metric_cache.clear();
+    bootstrap_cancel->fetchAndStoreRelaxed(1);
+    bootstrap_adrs.clear();
+    bootstrap_hv.clear();
+    bootstrap_summaries.clear();
+    hv_local.clear();
+    hv_all.reset(QPointF());
+    hv_default_valid = false;
+    pyramids.clear();
+    pyramid_generation++;
+    data_generation++;
 
     x_max = 0.0;
     y_max = 0.0;
@@ -213,6 +757,8 @@ void MainWindow::resetData()
     checkall_checkbox_change_enabled = true;
 
     initGraph();
+    initAnytimeGraph();
+    updateDesignViews();
 
     watcher->removePaths(watcher->files());
 }
@@ -225,7 +771,7 @@ void MainWindow::updateData(const QString & filePath)
     }
     else {
         analyseData();
-        updateGraph();
+        streamGraph();
     }
 
     watcher->addPath(filePath);
@@ -234,7 +780,8 @@ void MainWindow::updateData(const QString & filePath)
 int MainWindow::readCsvData(QString inputfilename)
 {
     int line_cnt = 0;
-    int i;
+    bool bulk_load = (data_line_cnt == 0);
+    const int first_method = qMax(itm_parent.size() - 1, 0);
 
     QString line;
     QStringList list;
@@ -274,8 +821,10 @@ int MainWindow::readCsvData(QString inputfilename)
 
             // Read head line
             if (line_cnt == 1) {
-                ui->dataTreeWidget->setColumnCount(list.size());
-                ui->dataTreeWidget->setHeaderLabels(list);
+                contribution_column = list.size();
+                ui->dataTreeWidget->setColumnCount(list.size() + 2);
+                ui->dataTreeWidget->setHeaderLabels(QStringList(list) << tr("HV Contribution") << tr("Crowding"));
+                designs.setHeader(list);
 
                 method_index = list.indexOf(tr("Method"));
                 iteration_index = list.indexOf(tr("Iteration"));
@@ -310,7 +859,7 @@ int MainWindow::readCsvData(QString inputfilename)
 
             // Read data
             else {
-                if (list.size() != ui->dataTreeWidget->columnCount()) {
+                if (list.size() != designs.columnCount()) {
                     if (ignore_enabled) continue;
 
                     int ret = QMessageBox::warning(this,
@@ -341,349 +890,1195 @@ int MainWindow::readCsvData(QString inputfilename)
 
                     data_points.resize(data_points.size() + 1);
                     op_points_local.resize(op_points_local.size() + 1);
+                    op_points_local_version.append(0);
+                    op_points_local_rows.resize(op_points_local_rows.size() + 1);
+                    data_items.resize(data_items.size() + 1);
+                    hv_local.resize(hv_local.size() + 1);
 
                     if (!itm_parent.empty()) {
                         itm_parent.last()->setExpanded(false);
                     }
-                    itm_parent.append(new QTreeWidgetItem(ui->dataTreeWidget, list.mid(0, 2)));
+                    itm_parent.append(new DataTreeItem(ui->dataTreeWidget, list.mid(0, 2)));
                     itm_parent.last()->setCheckState(0, Qt::Checked);
                     itm_parent.last()->setExpanded(true);
                 }
-                itm_parent.last()->addChild(new QTreeWidgetItem(list));
+                data_items[method_cnt] << new DataTreeItem(list);
+                data_items[method_cnt].last()->setData(0, Qt::UserRole, data_points[method_cnt].size());
+                itm_parent.last()->addChild(data_items[method_cnt].last());
+                designs.appendRow(method_cnt, list);
 
-                double x_value = list.at(x_var_index).toDouble();
-                double y_value = list.at(y_var_index).toDouble();
+                const QPointF plot_point = designs.plotPoint(designs.rowCount() - 1, x_var_index, y_var_index);
+                double x_value = plot_point.x();
+                double y_value = plot_point.y();
 
                 data_points[method_cnt] << QPointF(x_value, y_value);
 
                 x_max = (x_max > x_value)? x_max : x_value;
                 y_max = (y_max > y_value)? y_max : y_value;
 
-                // Decide if it is an optimal point for this interation
-                bool decision_op = true;
-                for(i = 0; i < op_points_local[method_cnt].size(); i++) {
-                    if((y_value >= op_points_local[method_cnt][i].y()) && (x_value >= op_points_local[method_cnt][i].x())) {
-                        decision_op = false;
-                        break;
+                // Fronts of a bulk load are built all at once after reading
+                if (bulk_load) continue;
+
+                // Decide if it is an optimal point for this interation, and if so for all
+                int index, evicted;
+                if (ParetoFront::insertPoint(op_points_local[method_cnt], QPointF(x_value, y_value), &index, &evicted)) {
+                    op_points_local_version[method_cnt]++;
+
+                    // Only the new point and its neighbours change, unless it is a new extreme
+                    QVector< int > &front_rows = op_points_local_rows[method_cnt];
+                    for (int k = index; k < index + evicted; k++) {
+                        clearFrontColumns(data_items[method_cnt][front_rows[k]]);
                     }
-                    else if (x_value <= op_points_local[method_cnt][i].x()) {
-                        break;
+                    front_rows.remove(index, evicted);
+                    front_rows.insert(index, data_points[method_cnt].size() - 1);
+                    hv_local[method_cnt].insert(QPointF(x_value, y_value));
+
+                    const int front_size = op_points_local[method_cnt].size();
+                    if ((index == 0) || (index == front_size - 1)) {
+                        updateFrontColumns(method_cnt, 0, front_size - 1);
                     }
-                }
-                if (decision_op)
-                {
-                    // insert by latency order and remove points that no longer optimal
-                    op_points_local[method_cnt].insert(i, QPointF(x_value, y_value));
-
-                    for (i = i + 1; i < op_points_local[method_cnt].size(); i++) {
-                        if(y_value <= op_points_local[method_cnt][i].y()) {
-                            op_points_local[method_cnt].remove(i);
-                            i--;
-                        }
+                    else {
+                        updateFrontColumns(method_cnt, index - 1, index + 1);
                     }
 
-                    // If it is optimal, then decide if it is optimal points for all
-                    decision_op = true;
-                    for(i = 0; i < op_points_all.size(); i++) {
-                        if((y_value >= op_points_all[i].y()) && (x_value >= op_points_all[i].x())) {
-                            decision_op = false;
-                            break;
-                        }
-                        else if (x_value <= op_points_all[i].x()) {
-                            break;
-                        }
-                    }
-                    if (decision_op) {
-                        op_points_all.insert(i, QPointF(x_value, y_value));
-
-                        for (i = i + 1; i < op_points_all.size(); i++) {
-                            if(y_value <= op_points_all[i].y()) {
-                                op_points_all.remove(i);
-                                i--;
-                            }
-                        }
+                    if (op_points_all.insert(QPointF(x_value, y_value), method_cnt)) {
+                        hv_all.insert(QPointF(x_value, y_value));
                     }
                 }
             }
         }
     }
 
+    if (bulk_load) {
+        op_points_local = ParetoFront::buildAll(data_points);
+        QVector< int > owners;
+        for (int i = 0; i < op_points_local.size(); i++) {
+            owners.append(i);
+        }
+        op_points_all.build(op_points_local, owners);
+
+        // Row of each front point: the first row with its value
+        op_points_local_rows.resize(op_points_local.size());
+        for (int i = 0; i < op_points_local.size(); i++) {
+            const QVector< QPointF > &front = op_points_local[i];
+            op_points_local_rows[i].fill(-1, front.size());
+            for (int r = 0; r < data_points[i].size(); r++) {
+                const QPointF &point = data_points[i][r];
+                int k = std::lower_bound(front.constBegin(), front.constEnd(), point,
+                                         [](const QPointF &a, const QPointF &b) { return a.x() < b.x(); }) - front.constBegin();
+                if ((k < front.size()) && (front[k].x() == point.x()) && (front[k].y() == point.y()) && (op_points_local_rows[i][k] == -1)) {
+                    op_points_local_rows[i][k] = r;
+                }
+            }
+        }
+    }
+
     file.close();
 
+    sortDesignRows(first_method);
+
     treeitem_change_enabled = true;
 
     return line_cnt;
 }
 
+/*
+ *     Start the metrics of the checked methods that are not cached yet
+ *
+ *     They are computed on the thread pool; a newer call cancels the
+ *     computation still in flight. Until the results arrive the tree shows
+ *     placeholders.
+ */
 void MainWindow::analyseData()
 {
-    double adrs;
-    double dominance;
-    double hypervolume;
+    updateHyperVolume();
 
+    const bool indicators_enabled = indicatorsEnabled();
+    MetricKey key = metricKey();
+
+    QVector< MetricTask::Job > jobs;
     for (int i = 0; i < itm_parent.size(); i++) {
-        if (itm_parent.at(i)->checkState(0) == Qt::Checked) {
-            adrs = calADRS(i);
-            dominance = calDominance(i);
-            hypervolume = calHyperVolume(i);
-            itm_parent.at(i)->setText(2, "ADRS:");
-            itm_parent.at(i)->setText(3, QString::number(adrs * 100.0, 10, 4) + "%");
-            itm_parent.at(i)->setText(4, "Dominance:");
-            itm_parent.at(i)->setText(5, QString::number(dominance * 100.0, 10, 4) + "%");
-            itm_parent.at(i)->setText(6, "HyperVolume");
-            itm_parent.at(i)->setText(7, QString::number(hypervolume * 100.0, 10, 4) + "%");
+        if (itm_parent.at(i)->checkState(0) != Qt::Checked) continue;
+
+        key.local_version = op_points_local_version[i];
+        const MetricRecord *cached = metric_cache.find(i, key);
+        if (cached && (!indicators_enabled || !cached->indicators.isEmpty())) continue;
+
+        MetricTask::Job job;
+        job.method = i;
+        job.front = op_points_local[i];
+        if (cached) {
+            job.record = *cached;
         }
         else {
-            itm_parent.at(i)->setText(3, "");
-            itm_parent.at(i)->setText(5, "");
-            itm_parent.at(i)->setText(7, "");
+            job.record.key = key;
+            job.record.adrs = 0.0;
+            job.record.dominance = golden_front.isEmpty() ? calDominance(i) : 0.0;
+            job.record.hypervolume = calHyperVolume(i);
         }
+        job.need_adrs = !cached;
+        job.need_dominance = !cached && !golden_front.isEmpty();
+        job.need_indicators = indicators_enabled;
+        jobs.append(job);
+    }
+
+    metric_cancel->fetchAndStoreRelaxed(1);
+    if (!jobs.isEmpty()) {
+        metric_cancel = MetricTask::CancelToken(new QAtomicInt(0));
+        metric_watcher->setFuture(QtConcurrent::run(MetricTask::run, jobs, referenceFront(), metric_cancel));
     }
+
+    showMetrics();
 }
 
-void MainWindow::getNewOptimalPoints()
+void MainWindow::metricsFinished()
 {
-    int k;
-    bool decision_op;
+    // results of a cancelled computation are stale
+    if (metric_cancel->loadAcquire()) return;
 
-    op_points_all.clear();
-    for (int i = 0; i < itm_parent.size(); i++) {
-        if (itm_parent.at(i)->checkState(0) == Qt::Checked) {
-            for (int j = 0; j < op_points_local[i].size(); j++) {
-                QPointF point = op_points_local[i][j];
-
-                decision_op = true;
-                for (k = 0; k < op_points_all.size(); k++) {
-                    if ((point.x() >= op_points_all[k].x()) && (point.y() >= op_points_all[k].y())) {
-                        decision_op = false;
-                        break;
-                    }
-                    else if (point.x() <= op_points_all[k].x()) {
-                        break;
-                    }
-                }
-                if (decision_op) {
-                    op_points_all.insert(k, point);
-                    for (k = k + 1; k < op_points_all.size(); k++) {
-                        if (point.y() <= op_points_all[k].y()) {
-                            op_points_all.remove(k);
-                            k--;
-                        }
-                    }
-                }
-            }
-        }
+    QVector< MetricTask::Job > jobs = metric_watcher->result();
+    for (int i = 0; i < jobs.size(); i++) {
+        metric_cache.insert(jobs[i].method, jobs[i].record);
     }
+
+    showMetrics();
 }
 
-/*
- *     Calculate dominance
- */
-double MainWindow::calDominance(int method_n)
+bool MainWindow::indicatorsEnabled()
 {
-    int dominance_cnt = 0;
-    for(int i = 0; i < op_points_local[method_n].size(); i++) {
-        for(int j = 0; j < op_points_all.size(); j++) {
-            if (op_points_local[method_n][i] == op_points_all[j]) {
-                dominance_cnt++;
-            }
+    for (int k = 0; k < indicator_actions.size(); k++) {
+        if (indicator_actions.at(k)->isChecked()) {
+            return true;
         }
     }
-
-    return (double)dominance_cnt/op_points_all.size();
+    return false;
 }
 
 /*
- *     Calculate ADRS
+ *     Metrics are only computed again when their fronts, axes or reference
+ *     changed; the local version is filled in per method
  */
-double MainWindow::calADRS(int method_n)
+MetricKey MainWindow::metricKey()
 {
-    double distance = 0.0;
-    double min_dis = 0.0;
-    double adrs = 0.0;
-    double adrs1 = 0.0;
-    double adrs2 = 0.0;
-    int mark = 0;
-    QVector<double > norm_dis;
+    MetricKey key;
+    key.global_version = golden_front.isEmpty() ? op_points_all.version() : 0;
+    key.local_version = 0;
+    key.golden_version = golden_version;
+    key.axes = x_var + "," + y_var;
+    key.reference = hyperVolumeReference();
+    return key;
+}
 
-    for (int i = 0; i < op_points_all.size(); i++)
-    {
-        norm_dis.append(sqrt(pow(op_points_all[i].x(),2) + pow(op_points_all[i].y(),2)));
+/*
+ *     Show the cached metrics of the checked methods, placeholders for the
+ *     ones still being computed
+ */
+void MainWindow::showMetrics()
+{
+    // Selected indicators follow the fixed and front columns as label/value pairs
+    const int indicator_column = qMax(8, contribution_column + 2);
+    const int last_column = indicator_column + 2 * FrontMetrics::IndicatorCount;
+    const bool indicators_enabled = indicatorsEnabled();
+    if (indicators_enabled && (ui->dataTreeWidget->columnCount() < last_column)) {
+        ui->dataTreeWidget->setColumnCount(last_column);
     }
 
-    for(int i = 0; i < op_points_local[method_n].size(); i++)
-    {
-        for(int j = 0; j < op_points_all.size(); j++)
-        {
-            distance = sqrt(pow((op_points_local[method_n][i].x() - op_points_all[j].x()),2) +
-                            pow((op_points_local[method_n][i].y() - op_points_all[j].y()),2));
-            if (j == 0) {
-                min_dis = distance;
-                mark = j;
-            }
-            else {
-                min_dis = (min_dis < distance)? min_dis : distance;
-                mark = (min_dis < distance)? mark : j;
-            }
+    // Both columns of a pair are headed by the name of its indicator
+    QTreeWidgetItem *header = ui->dataTreeWidget->headerItem();
+    for (int column = indicator_column, k = 0; column < ui->dataTreeWidget->columnCount(); column += 2) {
+        while ((k < indicator_actions.size()) && !(indicators_enabled && indicator_actions.at(k)->isChecked())) {
+            k++;
+        }
+        const QString name = (k < indicator_actions.size()) ? FrontMetrics::indicatorName(k++) : QString();
+        header->setText(column, name);
+        if (column + 1 < ui->dataTreeWidget->columnCount()) {
+            header->setText(column + 1, name);
         }
-        adrs1 += min_dis / norm_dis.at(mark);
     }
-    adrs1 /= op_points_local[method_n].size();
 
-    for(int i = 0; i < op_points_all.size(); i++)
-    {
-        for(int j = 0; j < op_points_local[method_n].size(); j++)
-        {
-            distance = sqrt(pow((op_points_local[method_n][j].x() - op_points_all[i].x()),2) +
-                            pow((op_points_local[method_n][j].y() - op_points_all[i].y()),2));
-            if (j == 0) {
-                min_dis = distance;
+    MetricKey key = metricKey();
+
+    QMap< QString, QVector< double > > adrs_samples;
+    QMap< QString, QVector< double > > hv_samples;
+
+    for (int i = 0; i < itm_parent.size(); i++) {
+        int column = indicator_column;
+        if (itm_parent.at(i)->checkState(0) == Qt::Checked) {
+            key.local_version = op_points_local_version[i];
+            const MetricRecord *record = metric_cache.find(i, key);
+
+            itm_parent.at(i)->setText(2, "ADRS:");
+            itm_parent.at(i)->setText(4, "Dominance:");
+            itm_parent.at(i)->setText(6, "HyperVolume");
+            if (record) {
+                adrs_samples[itm_parent.at(i)->text(0)] << record->adrs;
+                hv_samples[itm_parent.at(i)->text(0)] << record->hypervolume;
+
+                itm_parent.at(i)->setText(3, QString::number(record->adrs * 100.0, 10, 4) + "%");
+                itm_parent.at(i)->setText(5, QString::number(record->dominance * 100.0, 10, 4) + "%");
+                itm_parent.at(i)->setText(7, QString::number(record->hypervolume * 100.0, 10, 4) + "%");
             }
             else {
-                min_dis = (min_dis < distance)? min_dis : distance;
+                itm_parent.at(i)->setText(3, "...");
+                itm_parent.at(i)->setText(5, "...");
+                itm_parent.at(i)->setText(7, "...");
+            }
+
+            if (indicators_enabled) {
+                const bool indicators_ready = record && !record->indicators.isEmpty();
+                for (int k = 0; k < indicator_actions.size(); k++) {
+                    if (indicator_actions.at(k)->isChecked()) {
+                        itm_parent.at(i)->setText(column, FrontMetrics::indicatorName(k) + ":");
+                        if (!indicators_ready) {
+                            itm_parent.at(i)->setText(column + 1, "...");
+                        }
+                        else {
+                            itm_parent.at(i)->setText(column + 1, qIsNaN(record->indicators[k]) ? QString("-") : QString::number(record->indicators[k], 'g', 6));
+                        }
+                        column += 2;
+                    }
+                }
             }
         }
-        adrs2 += min_dis / norm_dis.at(i);
-    }
-    adrs2 /= op_points_all.size();
+        else {
+            itm_parent.at(i)->setText(3, "");
+            itm_parent.at(i)->setText(5, "");
+            itm_parent.at(i)->setText(7, "");
+        }
 
-    adrs = (adrs1 + adrs2) / 2;
+        for (; column < last_column; column++) {
+            itm_parent.at(i)->setText(column, "");
+        }
+    }
 
-    return adrs;
+    updateAggregateRows(adrs_samples, hv_samples);
+    updateAnytimeCurves();
 }
 
 /*
- *     Calculate HyperVolume
+ *     One row per method with the statistics of its checked iterations,
+ *     for methods with at least two of them
+ *
+ *     The bootstrap runs on the thread pool and only when the samples
+ *     changed; a newer run cancels the one still in flight. Until the
+ *     results arrive the rows show placeholders.
  */
-double MainWindow::calHyperVolume(int method_n)
+void MainWindow::updateAggregateRows(const QMap< QString, QVector< double > > &adrs_samples, const QMap< QString, QVector< double > > &hv_samples)
 {
-    double hypervolume = 0.0;
-    double hypervolume_base = 0.0;
-
-    for (int i = 0; i < op_points_local[method_n].size(); i++) {
-        if (i == 0) {
-            hypervolume += (op_points_local[method_n][i].x() - op_points_all[0].x()) *
-                           (op_points_local[method_n][i].y() + op_points_all[0].y()) * 0.5;
-        }
-        else {
-            hypervolume += (op_points_local[method_n][i].x() - op_points_local[method_n][i - 1].x()) *
-                           (op_points_local[method_n][i].y() + op_points_local[method_n][i - 1].y()) * 0.5;
+    if ((adrs_samples != bootstrap_adrs) || (hv_samples != bootstrap_hv)) {
+        bootstrap_cancel->fetchAndStoreRelaxed(1);
+        bootstrap_adrs = adrs_samples;
+        bootstrap_hv = hv_samples;
+        bootstrap_summaries.clear();
+
+        // ADRS and HyperVolume samples of each method in turn
+        QVector< QVector< double > > value_sets;
+        bootstrap_methods.clear();
+        QMap< QString, QVector< double > >::const_iterator it;
+        for (it = adrs_samples.constBegin(); it != adrs_samples.constEnd(); ++it) {
+            if (it.value().size() < 2) continue;
+
+            bootstrap_methods << it.key();
+            value_sets << it.value() << hv_samples.value(it.key());
         }
-    }
 
-    for (int i = (op_points_all.size() - 1); i >= 0; i--) {
-        if (i == (op_points_all.size() - 1)) {
-            hypervolume += (op_points_all[i].x() - op_points_local[method_n].last().x()) *
-                           (op_points_all[i].y() + op_points_local[method_n].last().y()) * 0.5;
-        }
-        else {
-            hypervolume += (op_points_all[i].x() - op_points_all[i + 1].x()) *
-                           (op_points_all[i].y() + op_points_all[i + 1].y()) * 0.5;
-            hypervolume_base += (op_points_all[i + 1].x() - op_points_all[i].x()) *
-                                (op_points_all[i + 1].y() + op_points_all[i].y()) * 0.5;
+        if (!value_sets.isEmpty()) {
+            bootstrap_cancel = MetricTask::CancelToken(new QAtomicInt(0));
+            bootstrap_watcher->setFuture(QtConcurrent::run(Bootstrap::summarizeAll, value_sets, bootstrap_resamples, 0.95,
+                                                           hv_seed, bootstrap_cancel));
         }
     }
 
-    return hypervolume / hypervolume_base;
+    showAggregateRows();
 }
 
-void MainWindow::initGraph()
+void MainWindow::bootstrapFinished()
 {
+    // results of a cancelled run are stale
+    if (bootstrap_cancel->loadAcquire()) return;
 
-    QCustomPlot *plot = ui->dataPlot;
+    QVector< Bootstrap::Summary > summaries = bootstrap_watcher->result();
+    for (int i = 0; (i < bootstrap_methods.size()) && (2 * i + 1 < summaries.size()); i++) {
+        bootstrap_summaries.insert(bootstrap_methods.at(i), qMakePair(summaries[2 * i], summaries[2 * i + 1]));
+    }
 
-    plot->clearGraphs();
-    plot->xAxis->setLabel(x_var);
-    plot->yAxis->setLabel(y_var);
+    showAggregateRows();
+}
+
+void MainWindow::showAggregateRows()
+{
+    QMap< QString, QTreeWidgetItem *>::const_iterator row;
+    for (row = itm_aggregate.constBegin(); row != itm_aggregate.constEnd(); ++row) {
+        row.value()->setHidden(bootstrap_adrs.value(row.key()).size() < 2);
+    }
+
+    QMap< QString, QVector< double > >::const_iterator it;
+    for (it = bootstrap_adrs.constBegin(); it != bootstrap_adrs.constEnd(); ++it) {
+        if (it.value().size() < 2) continue;
+
+        QTreeWidgetItem *item = itm_aggregate.value(it.key());
+        if (!item) {
+            item = new DataTreeItem(QStringList(it.key()));
+            QFont font = item->font(0);
+            font.setBold(true);
+            item->setFont(0, font);
+            item->setFont(1, font);
+            ui->dataTreeWidget->addTopLevelItem(item);
+            itm_aggregate.insert(it.key(), item);
+        }
+
+        item->setText(1, tr("%1 iterations").arg(it.value().size()));
+        item->setText(2, "ADRS:");
+        item->setText(6, "HyperVolume");
+        if (bootstrap_summaries.contains(it.key())) {
+            item->setText(3, summaryText(bootstrap_summaries.value(it.key()).first));
+            item->setText(7, summaryText(bootstrap_summaries.value(it.key()).second));
+        }
+        else {
+            item->setText(3, "...");
+            item->setText(7, "...");
+        }
+    }
+}
+
+QString MainWindow::summaryText(const Bootstrap::Summary &summary)
+{
+    return tr("mean %1% (median %2%, 95% CI %3% - %4%)")
+            .arg(summary.mean * 100.0, 0, 'f', 4)
+            .arg(summary.median * 100.0, 0, 'f', 4)
+            .arg(summary.lower * 100.0, 0, 'f', 4)
+            .arg(summary.upper * 100.0, 0, 'f', 4);
+}
+
+void MainWindow::getNewOptimalPoints()
+{
+    QVector< QVector< QPointF > > checked_fronts;
+    QVector< int > owners;
+    for (int i = 0; i < itm_parent.size(); i++) {
+        if (itm_parent.at(i)->checkState(0) == Qt::Checked) {
+            checked_fronts.append(op_points_local[i]);
+            owners.append(i);
+        }
+    }
+    op_points_all.build(checked_fronts, owners);
+    hv_default_valid = false;
+    rebuildHyperVolume(hv_all, op_points_all.points(), hyperVolumeReference());
+}
+
+/*
+ *     Calculate dominance
+ */
+double MainWindow::calDominance(int method_n)
+{
+    if (op_points_all.size() == 0) {
+        return 0.0;
+    }
+
+    return (double)op_points_all.ownedCount(method_n) / op_points_all.size();
+}
+
+/*
+ *     Calculate HyperVolume
+ */
+double MainWindow::calHyperVolume(int method_n)
+{
+    if (referenceHyperVolume() <= 0.0) {
+        return 0.0;
+    }
+
+    return hv_local[method_n].value() / referenceHyperVolume();
+}
+
+void MainWindow::rebuildHyperVolume(IncrementalHypervolume &hypervolume, const QVector< QPointF > &front, const QPointF &reference)
+{
+    hypervolume.reset(reference);
+    for (int i = 0; i < front.size(); i++) {
+        hypervolume.insert(front[i]);
+    }
+}
+
+/*
+ *     Hypervolumes follow the fronts row by row while reading; they are only
+ *     rebuilt when the reference point moves
+ */
+void MainWindow::updateHyperVolume()
+{
+    QPointF reference = hyperVolumeReference();
+    QVector< double > reference_2d;
+    reference_2d << reference.x() << reference.y();
+
+    if (hv_all.reference() != reference_2d) {
+        rebuildHyperVolume(hv_all, op_points_all.points(), reference);
+    }
+    if (!golden_front.isEmpty() && (hv_golden.reference() != reference_2d)) {
+        rebuildHyperVolume(hv_golden, golden_front, reference);
+    }
+    for (int i = 0; i < hv_local.size(); i++) {
+        if (hv_local[i].reference() != reference_2d) {
+            rebuildHyperVolume(hv_local[i], op_points_local[i], reference);
+            updateFrontColumns(i, 0, op_points_local[i].size() - 1);
+        }
+    }
+}
+
+void MainWindow::initGraph()
+{
+
+    QCustomPlot *plot = ui->dataPlot;
+
+    plot->clearPlottables();
+    plotted_rows.clear();
+    streamed_rows.clear();
+
+    // Density of the rows, under every graph
+    density_map = new QCPColorMap(plot->xAxis, plot->yAxis);
+    density_map->setName("Density");
+    density_map->setLayer("density");
+    density_map->setGradient(QCPColorGradient::gpThermal);
+    density_map->setDataScaleType(QCPAxis::stLogarithmic);
+    density_map->setInterpolate(false);
+    density_map->setVisible(false);
+    DensityMap::Grid no_grid = { 0.0, 0.0, 0.0, 0.0, 0, 0 };
+    density_grid = no_grid;
+    density_counts.clear();
+    binned_rows.clear();
+    binned_checked.clear();
+
+    // Marker of the design selected in the table or the plot, over the fronts
+    selection_curve = new QCPCurve(plot->xAxis, plot->yAxis);
+    selection_curve->setName("Selection");
+    selection_curve->setLayer("selection");
+    selection_curve->setPen(QPen(Qt::black, 2));
+    selection_curve->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, 12));
+    selection_curve->setLineStyle(QCPCurve::lsNone);
+    selection_curve->setSelectable(QCP::stNone);
+    selection_curve->removeFromLegend();
+    selected_method = -1;
+    selected_row = -1;
+    pick_index.clear();
+    pick_refs.clear();
+    pick_index_valid = false;
+
+    // Rows, rows streamed in since the last full replot and fronts of all
+    // methods, each in a single plottable
+    row_scatter = new GroupScatter(plot->xAxis, plot->yAxis);
+    row_scatter->setName("Rows");
+    row_scatter->setLayer("data");
+    row_scatter->setPointSets(&data_points);
+    row_scatter->removeFromLegend();
+
+    increment_scatter = new GroupScatter(plot->xAxis, plot->yAxis);
+    increment_scatter->setName("New rows");
+    increment_scatter->setLayer("increment");
+    increment_scatter->setPointSets(&data_points);
+    increment_scatter->removeFromLegend();
+
+    front_set = new GroupFronts(plot->xAxis, plot->yAxis);
+    front_set->setName("Fronts");
+    front_set->setLayer("fronts");
+    front_set->setFronts(&op_points_local);
+    front_set->removeFromLegend();
+    group_legend->setGroups(QVector< int >(), QStringList(), QVector< QColor >());
+
+    plot->xAxis->setLabel(x_var);
+    plot->yAxis->setLabel(y_var);
     plot->xAxis->setRange(0, x_max * 1.1);
     plot->yAxis->setRange(0, y_max * 1.1);
     plot->setInteractions(QCP::iRangeZoom | QCP::iRangeDrag | QCP::iSelectPlottables);
 
     plot->legend->setVisible(false);
     plot->legend->setSelectableParts(QCPLegend::spItems);
-    connect(plot, SIGNAL(legendDoubleClick(QCPLegend*,QCPAbstractLegendItem*,QMouseEvent*)), this, SLOT(toggleGraphVisible(QCPLegend*,QCPAbstractLegendItem*)));
+    connect(plot, SIGNAL(legendDoubleClick(QCPLegend*,QCPAbstractLegendItem*,QMouseEvent*)),
+            this, SLOT(toggleGraphVisible(QCPLegend*,QCPAbstractLegendItem*,QMouseEvent*)), Qt::UniqueConnection);
 
     plot->addGraph();
     plot->graph()->setName("Base Line");
+    plot->graph()->setLayer("fronts");
     plot->graph()->setPen(QPen(Qt::red));
     plot->graph()->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDiamond, 6));
     plot->graph()->setLineStyle(QCPGraph::lsLine);
     plot->graph()->removeFromLegend();
-    setGraphData(op_points_all, plot->graph());
+    base_global_version = -1;
+    base_golden_version = -1;
+    updateBaseLine();
 
     plot->replot();
 }
 
+/*
+ *     Graph 0 is the base line; the rows and fronts of all methods are
+ *     drawn by row_scatter and front_set, which read data_points and
+ *     op_points_local in place
+ *
+ *     A refresh only hands over the row counts, colors and checked
+ *     methods, so new rows cost no copy. The legend lists the checked
+ *     methods in a single scrolling entry instead of one entry per graph.
+ */
 void MainWindow::updateGraph()
 {
     QCustomPlot *plot = ui->dataPlot;
 
+    graph_x_max = x_max;
+    graph_y_max = y_max;
+    graph_generation = data_generation;
     plot->xAxis->setRange(0, x_max * 1.1);
     plot->yAxis->setRange(0, y_max * 1.1);
-    plot->legend->clear();
     plot->legend->setVisible(true);
 
-    setGraphData(op_points_all, plot->graph(0));
+    updateBaseLine();
     plot->graph(0)->addToLegend();
 
-    for (int i = 0; i < plot->graphCount() / 2; i++) {
-        setGraphData(op_points_local[i], plot->graph(2 * i + 1));
-        plot->graph(2 * i + 1)->setVisible((itm_parent.at(i)->checkState(0) == Qt::Checked) && (ui->showOpRaioButton->isChecked()));
-        if (plot->graph(2 * i + 1)->visible()) {
-            plot->graph(2 * i + 1)->addToLegend();
+    const int group_cnt = itm_parent.size();
+    QVector< QColor > colors(group_cnt);
+    QVector< bool > checked(group_cnt);
+    QVector< QVector< double > > sizes(group_cnt);
+    QVector< int > legend_groups;
+    QStringList legend_names;
+    QVector< QColor > legend_colors;
+    for (int i = 0; i < group_cnt; i++) {
+        colors[i] = methodColor(i);
+        checked[i] = (itm_parent.at(i)->checkState(0) == Qt::Checked);
+        sizes[i] = frontPointSizes(i);
+        if (checked[i]) {
+            legend_groups.append(i);
+            legend_names.append(itm_parent.at(i)->text(0) + " " + itm_parent.at(i)->text(1));
+            legend_colors.append(colors[i]);
         }
+    }
+
+    plotted_rows.resize(group_cnt);
+    for (int i = 0; i < group_cnt; i++) {
+        plotted_rows[i] = data_points[i].size();
+    }
+    streamed_rows = plotted_rows;
+
+    const bool show_rows = ui->showAllRadioButton->isChecked();
+    const bool show_fronts = ui->showOpRaioButton->isChecked() || ui->showDensityRadioButton->isChecked();
+
+    row_scatter->setPalette(colors);
+    row_scatter->setGroupsVisible(checked);
+    row_scatter->setGeneration(data_generation);
+    row_scatter->setRows(QVector< int >(group_cnt, 0), plotted_rows);
+    row_scatter->setPyramids(pyramids);
+    row_scatter->setScatterSkip(scatter_skip);
+    row_scatter->setVisible(show_rows);
+
+    increment_scatter->setPalette(colors);
+    increment_scatter->setGroupsVisible(checked);
+    increment_scatter->setGeneration(data_generation);
+    increment_scatter->setRows(plotted_rows, streamed_rows);
+    increment_scatter->setScatterSkip(scatter_skip);
+    increment_scatter->setVisible(show_rows);
+
+    front_set->setPalette(colors);
+    front_set->setGroupsVisible(checked);
+    front_set->setPointSizes(sizes);
+    front_set->setVisible(show_fronts);
+
+    group_legend->setGroups(legend_groups, legend_names, legend_colors);
+
+    updateDensity();
+    updatePyramids();
+    updateDesignViews();
+
+    QElapsedTimer replot_clock;
+    replot_clock.start();
+    plot->replot();
+    adaptFrameRate(replot_clock.elapsed());
+    frame_clock.restart();
+}
+
+/*
+ *     Ask for a redraw of the data plot
+ *
+ *     The redraw runs from the event loop at most once per display frame,
+ *     so the several requests one user action makes cost a single replot.
+ */
+void MainWindow::scheduleGraph()
+{
+    if (!frame_timer->isActive()) {
+        frame_timer->start(int(qMax(qint64(0), frame_interval - frame_clock.elapsed())));
+    }
+}
+
+/*
+ *     Switch between full and decimated drawing of the rows
+ *
+ *     A replot over the frame budget doubles the number of row markers
+ *     skipped from the next one on; one well within it halves it again.
+ */
+void MainWindow::adaptFrameRate(qint64 replot_time)
+{
+    const int budget = (frame_budget > 0) ? frame_budget : frame_interval;
+    const int last_skip = scatter_skip;
 
-        setGraphData(data_points[i],     plot->graph(2 * i + 2));
-        plot->graph(2 * i + 2)->setVisible((itm_parent.at(i)->checkState(0) == Qt::Checked) && (ui->showAllRadioButton->isChecked()));
-        if (plot->graph(2 * i + 2)->visible()) {
-            plot->graph(2 * i + 2)->addToLegend();
+    if (replot_time > budget) {
+        scatter_skip = qMin(2 * scatter_skip + 1, 63);
+    }
+    else if (replot_time * 4 < budget) {
+        scatter_skip /= 2;
+    }
+    if (scatter_skip == last_skip) {
+        return;
+    }
+
+    ui->dataPlot->setNotAntialiasedElements((scatter_skip > 0) ? QCP::aePlottables : QCP::aeNone);
+    if ((scatter_skip > 0) != (last_skip > 0)) {
+        ui->consoleText->append((scatter_skip > 0) ? tr("Replot took %1 ms, drawing fewer points").arg(replot_time)
+                                                   : tr("Drawing all points again"));
+    }
+}
+
+/*
+ *     Start indexing the rows of large methods in the background
+ *
+ *     Only one update runs at a time; when it finishes the next one is
+ *     started if rows kept arriving meanwhile.
+ */
+void MainWindow::updatePyramids()
+{
+    if (pyramid_watcher->isRunning()) {
+        return;
+    }
+
+    bool stale = false;
+    for (int i = 0; i < data_points.size(); i++) {
+        stale = stale || PointPyramid::needsUpdate(pyramids.value(i), data_points[i].size());
+    }
+    if (stale) {
+        pyramid_launch_generation = pyramid_generation;
+        pyramid_watcher->setFuture(QtConcurrent::run(PointPyramid::updateAll, pyramids, data_points));
+    }
+}
+
+/*
+ *     Hand the new pyramids to the row plottable; results of a file that
+ *     was closed meanwhile are dropped
+ */
+void MainWindow::pyramidsFinished()
+{
+    if (pyramid_launch_generation != pyramid_generation) {
+        updatePyramids();
+        return;
+    }
+
+    const QVector< QSharedPointer< const PointPyramid > > result = pyramid_watcher->result();
+    pyramids.resize(qMax(pyramids.size(), result.size()));
+    for (int i = 0; i < result.size(); i++) {
+        pyramids[i] = result[i];
+    }
+    row_scatter->setPyramids(pyramids);
+    ui->dataPlot->replot(QCustomPlot::rpQueuedReplot);
+    updatePyramids();
+}
+
+/*
+ *     Set the points of an x-sorted front, without sorting them again
+ */
+void MainWindow::setGraphData(const QVector<QPointF> &points, QCPGraph *graph)
+{
+    QVector<QCPGraphData> data(points.size());
+
+    for (int i = 0; i < points.size(); i++) {
+        data[i].key = points[i].x();
+        data[i].value = points[i].y();
+    }
+    graph->data()->set(data, true);
+}
+
+/*
+ *     Copy the reference front into the base line only when its points
+ *     changed; the global front keeps its version while they stay the same
+ */
+void MainWindow::updateBaseLine()
+{
+    const int global_version = golden_front.isEmpty() ? op_points_all.version() : -1;
+    if ((global_version == base_global_version) && (golden_version == base_golden_version)) {
+        return;
+    }
+
+    setGraphData(referenceFront(), ui->dataPlot->graph(0));
+    base_global_version = global_version;
+    base_golden_version = golden_version;
+}
+
+/*
+ *     Refresh after rows were appended to the file
+ *
+ *     While the axes keep their range and no method was added, the new rows
+ *     go to the increment plottable and only the increment, front and density
+ *     layers are repainted; the buffer of the rows plotted before is
+ *     reused as is, and the increment splats only the rows new since the
+ *     last tick over its kept image. Layer replots are dropped while the
+ *     paint buffers wait for a full replot, so that case takes one.
+ */
+void MainWindow::streamGraph()
+{
+    QCustomPlot *plot = ui->dataPlot;
+    if ((plotted_rows.size() != itm_parent.size()) || (graph_x_max != x_max) || (graph_y_max != y_max) ||
+        (graph_generation != data_generation) || ui->dataPlot->buffersInvalidated()) {
+        scheduleGraph();
+        return;
+    }
+    pick_index_valid = false;
+    scheduleDesignViews();
+
+    bool increment_changed = false;
+    QVector< QVector< double > > sizes(plotted_rows.size());
+    for (int i = 0; i < plotted_rows.size(); i++) {
+        sizes[i] = frontPointSizes(i);
+        if (streamed_rows[i] < data_points[i].size()) {
+            streamed_rows[i] = data_points[i].size();
+            increment_changed = increment_changed || (itm_parent.at(i)->checkState(0) == Qt::Checked);
         }
     }
+    increment_changed = increment_changed && increment_scatter->visible();
+    increment_scatter->setRows(plotted_rows, streamed_rows);
+    front_set->setPointSizes(sizes);
+    updateBaseLine();
+    updatePyramids();
+
+    if (updateDensity()) {
+        plot->layer("density")->replot();
+    }
+    if (increment_changed) {
+        plot->layer("increment")->replot();
+    }
+    plot->layer("fronts")->replot();
+}
 
-    // Add new graphs
-    for (int i = plot->graphCount() / 2; i < itm_parent.size(); i++) {
-        // Add graph for optimal line for each iterations
-        plot->addGraph();
-        plot->graph()->setName(itm_parent.at(i)->text(0) + "_op");
-        plot->graph()->setPen(QPen(QColor(qSin(i*0.6)*100+100, qSin(i*1.2+0.7)*100+100, qSin(i*0.8+0.6)*100+100)));
-        plot->graph()->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, 4));
-        plot->graph()->setLineStyle(QCPGraph::lsLine);
-        setGraphData(op_points_local[i], plot->graph());
-        plot->graph()->setVisible((itm_parent.at(i)->checkState(0) == Qt::Checked) && (ui->showOpRaioButton->isChecked()));
-        if (!plot->graph()->visible()) {
-            plot->graph()->removeFromLegend();
+/*
+ *     HyperVolume contribution and crowding distance of the front points
+ *     first..last of a method, shown on the rows they came from
+ */
+void MainWindow::updateFrontColumns(int method_n, int first, int last)
+{
+    const QVector< QPointF > &front = op_points_local[method_n];
+    const QVector< double > &reference_2d = hv_local[method_n].reference();
+    const QPointF reference(reference_2d[0], reference_2d[1]);
+
+    first = qMax(first, 0);
+    last = qMin(last, front.size() - 1);
+    for (int i = first; i <= last; i++) {
+        QTreeWidgetItem *item = data_items[method_n][op_points_local_rows[method_n][i]];
+        item->setText(contribution_column, QString::number(ParetoFront::contribution(front, i, reference), 'g', 6));
+        item->setText(contribution_column + 1, QString::number(ParetoFront::crowding(front, i), 'g', 6));
+    }
+}
+
+void MainWindow::clearFrontColumns(QTreeWidgetItem *item)
+{
+    item->setText(contribution_column, "");
+    item->setText(contribution_column + 1, "");
+}
+
+/*
+ *     Scatter sizes of a method's front points, 3 to 12 pixels by the
+ *     selected measure; empty for fixed sizes
+ */
+QVector< double > MainWindow::frontPointSizes(int method_n)
+{
+    QVector< double > sizes;
+    if (point_size_mode == 0) {
+        return sizes;
+    }
+
+    const QVector< QPointF > &front = op_points_local[method_n];
+    const QVector< double > &reference_2d = hv_local[method_n].reference();
+    const QPointF reference(reference_2d[0], reference_2d[1]);
+
+    QVector< double > values;
+    double max_value = 0.0;
+    for (int i = 0; i < front.size(); i++) {
+        values << ((point_size_mode == 1) ? ParetoFront::contribution(front, i, reference) : ParetoFront::crowding(front, i));
+        if (qIsFinite(values.last())) {
+            max_value = qMax(max_value, values.last());
         }
+    }
 
-        // Add graph for all points for each iterations
-        plot->addGraph();
-        plot->graph()->setName(itm_parent.at(i)->text(0) + "_all");
-        plot->graph()->setPen(QPen(QColor(qSin(i*0.6)*100+100, qSin(i*1.2+0.7)*100+100, qSin(i*0.8+0.6)*100+100)));
-        plot->graph()->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, 4));
-        plot->graph()->setLineStyle(QCPGraph::lsNone);
-        setGraphData(data_points[i],     plot->graph());
-        plot->graph()->setVisible((itm_parent.at(i)->checkState(0) == Qt::Checked) && (ui->showAllRadioButton->isChecked()));
-        if (!plot->graph()->visible()) {
-            plot->graph()->removeFromLegend();
+    for (int i = 0; i < values.size(); i++) {
+        if (!qIsFinite(values[i])) {
+            sizes << 12.0;
+        }
+        else {
+            sizes << 3.0 + 9.0 * ((max_value > 0.0) ? sqrt(values[i] / max_value) : 0.0);
         }
     }
 
+    return sizes;
+}
+
+void MainWindow::initAnytimeGraph()
+{
+    QCustomPlot *plot = ui->anytimePlot;
+
+    anytime_cancel->fetchAndStoreRelaxed(1);
+    anytime_pending = false;
+    anytime_curves.clear();
+    anytime_reference = AnytimeCurves::makeReference(QVector< QPointF >(), QPointF(), 0.0);
+
+    plot->clearGraphs();
+    plot->xAxis->setLabel("Evaluated designs");
+    plot->yAxis->setLabel(ui->anytimeMetricList->currentText() + " (%)");
+    plot->setInteractions(QCP::iRangeZoom | QCP::iRangeDrag);
     plot->replot();
 }
 
-void MainWindow::setGraphData(QVector<QPointF> points, QCPGraph *graph)
+/*
+ *     Anytime curves of every method against the current global front
+ *
+ *     Only computed while the panel is shown, on the thread pool. Rows
+ *     streamed in extend each curve from its last row, after the extension
+ *     still in flight, and a new method starts a curve of its own. The
+ *     curves are replayed from the first row only when the points of the
+ *     reference front or the reference point changed, which cancels it;
+ *     a new version of the global front with the same points keeps them.
+ *     Until the results arrive the plot shows the curves accepted last and
+ *     marks them as being updated.
+ */
+void MainWindow::updateAnytimeCurves()
 {
-    QVector<double> x, y;
+    if (!ui->actionAnytime_Curves->isChecked()) {
+        return;
+    }
 
-    for (int i = 0; i < points.size(); i++) {
-        x << points[i].x();
-        y << points[i].y();
+    const AnytimeCurves::Reference reference = AnytimeCurves::makeReference(referenceFront(), hyperVolumeReference(), referenceHyperVolume());
+    if (!AnytimeCurves::sameReference(reference, anytime_reference)) {
+        anytime_cancel->fetchAndStoreRelaxed(1);
+        anytime_curves.clear();
+        anytime_reference = reference;
+    }
+    else if (anytime_watcher->isRunning() && !anytime_cancel->loadAcquire()) {
+        anytime_pending = true;
+        updateAnytimeGraph();
+        return;
+    }
+
+    // Only new methods, or methods whose rows were replaced, start over
+    const int curve_cnt = anytime_curves.size();
+    anytime_curves.resize(data_points.size());
+    for (int i = 0; i < anytime_curves.size(); i++) {
+        if ((i >= curve_cnt) || (anytime_curves[i].rowCount() > data_points[i].size())) {
+            anytime_curves[i].reset(anytime_reference, ui->anytimeStrideSpin->value());
+        }
     }
-    graph->setData(x, y);
+
+    // Only the rows the curves have not seen are handed over
+    QVector< QVector< QPointF > > new_rows(data_points.size());
+    bool grown = false;
+    for (int i = 0; i < data_points.size(); i++) {
+        const int row_cnt = anytime_curves[i].rowCount();
+        if (row_cnt < data_points[i].size()) {
+            new_rows[i] = data_points[i].mid(row_cnt);
+            grown = true;
+        }
+    }
+
+    anytime_pending = false;
+    if (grown) {
+        anytime_cancel = MetricTask::CancelToken(new QAtomicInt(0));
+        anytime_watcher->setFuture(QtConcurrent::run(AnytimeCurves::run, anytime_curves, new_rows, anytime_cancel));
+    }
+
+    updateAnytimeGraph();
 }
 
-void MainWindow::toggleGraphVisible(QCPLegend *legend, QCPAbstractLegendItem *item)
+void MainWindow::anytimeFinished()
+{
+    // results of a cancelled run are stale
+    if (anytime_cancel->loadAcquire()) return;
+
+    anytime_curves = anytime_watcher->result();
+    if (anytime_pending) {
+        updateAnytimeCurves();
+    }
+    else {
+        updateAnytimeGraph();
+    }
+}
+
+void MainWindow::updateAnytimeGraph()
+{
+    QCustomPlot *plot = ui->anytimePlot;
+    const int metric = ui->anytimeMetricList->currentIndex();
+
+    plot->clearGraphs();
+    plot->xAxis->setLabel(anytime_watcher->isRunning() ? tr("Evaluated designs (updating...)") : tr("Evaluated designs"));
+    plot->yAxis->setLabel(ui->anytimeMetricList->currentText() + " (%)");
+
+    for (int i = 0; (metric >= 0) && (i < anytime_curves.size()); i++) {
+        QVector< double > values = anytime_curves[i].curve().values[metric];
+        for (int k = 0; k < values.size(); k++) {
+            values[k] *= 100.0;
+        }
+
+        plot->addGraph();
+        plot->graph()->setName(itm_parent.at(i)->text(0));
+        plot->graph()->setPen(QPen(methodColor(i)));
+        plot->graph()->setLineStyle(QCPGraph::lsStepLeft);
+        plot->graph()->setData(anytime_curves[i].curve().evaluations, values, true);
+        plot->graph()->setVisible(itm_parent.at(i)->checkState(0) == Qt::Checked);
+    }
+
+    plot->rescaleAxes(true);
+    plot->replot();
+}
+
+/*
+ *     Density of the checked rows, one cell per pixel of the axis rect
+ *
+ *     New rows are binned into the existing histogram; everything is binned
+ *     again when the view or the checked methods change. The color map
+ *     maps cells evenly in data coordinates, so it is not shown on log
+ *     axes. Returns true if the map changed.
+ */
+bool MainWindow::updateDensity()
+{
+    QCustomPlot *plot = ui->dataPlot;
+    const bool log_scale = (plot->xAxis->scaleType() == QCPAxis::stLogarithmic) ||
+                           (plot->yAxis->scaleType() == QCPAxis::stLogarithmic);
+    density_map->setVisible(ui->showDensityRadioButton->isChecked() && !log_scale);
+    if (!density_map->visible()) {
+        return false;
+    }
+
+    DensityMap::Grid grid;
+    grid.x_lower = plot->xAxis->range().lower;
+    grid.x_upper = plot->xAxis->range().upper;
+    grid.y_lower = plot->yAxis->range().lower;
+    grid.y_upper = plot->yAxis->range().upper;
+    grid.nx = qMax(1, plot->axisRect()->width());
+    grid.ny = qMax(1, plot->axisRect()->height());
+
+    bool rebin = !(grid == density_grid) || (binned_rows.size() > data_points.size());
+    for (int i = binned_rows.size(); i < data_points.size(); i++) {
+        binned_rows.append(0);
+        binned_checked.append(itm_parent.at(i)->checkState(0) == Qt::Checked);
+    }
+    for (int i = 0; i < data_points.size(); i++) {
+        if (binned_checked[i] != (itm_parent.at(i)->checkState(0) == Qt::Checked)) {
+            rebin = true;
+        }
+    }
+
+    if (rebin) {
+        density_grid = grid;
+        density_counts.fill(0, grid.nx * grid.ny);
+        for (int i = 0; i < data_points.size(); i++) {
+            binned_rows[i] = 0;
+            binned_checked[i] = (itm_parent.at(i)->checkState(0) == Qt::Checked);
+        }
+    }
+
+    bool changed = rebin;
+    for (int i = 0; i < data_points.size(); i++) {
+        if (binned_checked[i] && (binned_rows[i] < data_points[i].size())) {
+            DensityMap::binPoints(data_points[i], binned_rows[i], grid, density_counts);
+            binned_rows[i] = data_points[i].size();
+            changed = true;
+        }
+    }
+    if (!changed) {
+        return false;
+    }
+
+    const double dx = (grid.x_upper - grid.x_lower) / grid.nx;
+    const double dy = (grid.y_upper - grid.y_lower) / grid.ny;
+    QCPColorMapData *data = density_map->data();
+    data->setSize(grid.nx, grid.ny);
+    data->setRange(QCPRange(grid.x_lower + dx / 2, grid.x_upper - dx / 2), QCPRange(grid.y_lower + dy / 2, grid.y_upper - dy / 2));
+
+    quint32 max_count = 0;
+    for (int y = 0; y < grid.ny; y++) {
+        for (int x = 0; x < grid.nx; x++) {
+            const quint32 count = density_counts[y * grid.nx + x];
+            data->setCell(x, y, count);
+            data->setAlpha(x, y, count ? 255 : 0);
+            max_count = qMax(max_count, count);
+        }
+    }
+    density_map->setDataRange(QCPRange(1, qMax(max_count, quint32(2))));
+    return true;
+}
+
+/*
+ *     Ask for a rebin of the density after the view moved
+ *
+ *     Both axes change on a zoom and every step of a drag changes one, so
+ *     the requests are merged and served once per display frame. A full
+ *     redraw is not used here as it would reset the view.
+ */
+void MainWindow::densityRangeChanged()
+{
+    if (ui->showDensityRadioButton->isChecked() && !density_timer->isActive()) {
+        density_timer->start(frame_interval);
+    }
+}
+
+void MainWindow::refreshDensity()
+{
+    if (ui->showDensityRadioButton->isChecked() && updateDensity()) {
+        ui->dataPlot->replot(QCustomPlot::rpQueuedReplot);
+    }
+}
+
+void MainWindow::invalidatePickIndex()
+{
+    pick_index_valid = false;
+}
+
+/*
+ *     Index the designs drawn on the plot by their pixel position
+ *
+ *     Only the points inside the axis rect are indexed: all the rows of
+ *     the checked methods, or just their front points when only the
+ *     optimum lines are shown. The index is rebuilt on the first query
+ *     after a replot or after rows were added.
+ */
+void MainWindow::updatePickIndex()
+{
+    if (pick_index_valid) {
+        return;
+    }
+    pick_index_valid = true;
+
+    QCustomPlot *plot = ui->dataPlot;
+    const QRect rect = plot->axisRect()->rect();
+    const bool fronts_only = ui->showOpRaioButton->isChecked();
+
+    QVector< QPointF > positions;
+    pick_refs.clear();
+    for (int i = 0; i < data_points.size(); i++) {
+        if (itm_parent.at(i)->checkState(0) != Qt::Checked) continue;
+
+        const int count = fronts_only ? op_points_local_rows[i].size() : data_points[i].size();
+        for (int k = 0; k < count; k++) {
+            const int row = fronts_only ? op_points_local_rows[i][k] : k;
+            const QPointF pixel(plot->xAxis->coordToPixel(data_points[i][row].x()),
+                                plot->yAxis->coordToPixel(data_points[i][row].y()));
+            if (!rect.contains(pixel.toPoint())) continue;
+
+            positions.append(pixel);
+            pick_refs.append(qMakePair(i, row));
+        }
+    }
+
+    pick_index.build(positions, 8.0);
+}
+
+/*
+ *     Design drawn closest to a pixel, as an index into pick_refs, or -1
+ */
+int MainWindow::pickDesign(const QPoint &pos)
+{
+    updatePickIndex();
+    return pick_index.nearest(QPointF(pos), 8.0);
+}
+
+/*
+ *     Tool tip of a design: its values and the metrics of its method
+ */
+QString MainWindow::designToolTip(int method_n, int row)
+{
+    const QTreeWidgetItem *header = ui->dataTreeWidget->headerItem();
+    const QTreeWidgetItem *item = data_items[method_n][row];
+    const QTreeWidgetItem *parent = itm_parent.at(method_n);
+
+    QStringList lines;
+    lines << parent->text(0) + " " + parent->text(1) + tr(", row %1").arg(row + 1);
+    for (int c = 2; c < header->columnCount(); c++) {
+        if (!item->text(c).isEmpty()) {
+            lines << header->text(c) + ": " + item->text(c);
+        }
+    }
+    for (int c = 2; c + 1 < parent->columnCount(); c += 2) {
+        if (!parent->text(c).isEmpty()) {
+            lines << parent->text(c) + " " + parent->text(c + 1);
+        }
+    }
+    return lines.join("\n");
+}
+
+/*
+ *     Mark the selected design on the plot
+ */
+void MainWindow::showSelection()
+{
+    QVector< double > keys;
+    QVector< double > values;
+    if (selected_method >= 0) {
+        keys << data_points[selected_method][selected_row].x();
+        values << data_points[selected_method][selected_row].y();
+    }
+    selection_curve->setData(keys, values);
+    ui->dataPlot->layer("selection")->replot();
+}
+
+void MainWindow::plotMouseMove(QMouseEvent *event)
+{
+    if (event->buttons() != Qt::NoButton) {
+        return;
+    }
+
+    const int pick = pickDesign(event->pos());
+    if (pick < 0) {
+        QToolTip::hideText();
+        return;
+    }
+    QToolTip::showText(event->globalPos(), designToolTip(pick_refs[pick].first, pick_refs[pick].second), ui->dataPlot);
+}
+
+void MainWindow::plotMousePress(QMouseEvent *event)
+{
+    press_pos = event->pos();
+}
+
+/*
+ *     A click that did not drag the plot selects the design under it in
+ *     the table, along with the row holding the metrics of its method
+ */
+void MainWindow::plotMouseRelease(QMouseEvent *event)
+{
+    if ((event->button() != Qt::LeftButton) || ((event->pos() - press_pos).manhattanLength() > 3)) {
+        return;
+    }
+
+    const int pick = pickDesign(event->pos());
+    if (pick < 0) {
+        return;
+    }
+
+    QTreeWidgetItem *item = data_items[pick_refs[pick].first][pick_refs[pick].second];
+    item->parent()->setExpanded(true);
+    ui->dataTreeWidget->setCurrentItem(item);
+    item->parent()->setSelected(true);
+    ui->dataTreeWidget->scrollToItem(item);
+}
+
+void MainWindow::on_dataTreeWidget_currentItemChanged(QTreeWidgetItem *current, QTreeWidgetItem *previous)
+{
+    Q_UNUSED(previous)
+    selected_method = current ? itm_parent.indexOf(current->parent()) : -1;
+    selected_row = (selected_method >= 0) ? current->data(0, Qt::UserRole).toInt() : -1;
+    if (selected_row < 0) {
+        selected_method = -1;
+    }
+    showSelection();
+}
+
+/*
+ *     Double-clicking a method in the legend unchecks it
+ */
+void MainWindow::toggleGraphVisible(QCPLegend *legend, QCPAbstractLegendItem *item, QMouseEvent *event)
 {
     Q_UNUSED(legend)
+    if (item == group_legend) {
+        const int group = group_legend->groupAt(event->pos());
+        if (group >= 0) {
+            itm_parent.at(group)->setCheckState(0, Qt::Unchecked);
+        }
+        return;
+    }
     if (item) {
         item->setVisible(!item->visible());
     }
@@ -691,12 +2086,17 @@ void MainWindow::toggleGraphVisible(QCPLegend *legend, QCPAbstractLegendItem *it
 
 void MainWindow::on_showOpRaioButton_clicked()
 {
-    updateGraph();
+    scheduleGraph();
 }
 
 void MainWindow::on_showAllRadioButton_clicked()
 {
-    updateGraph();
+    scheduleGraph();
+}
+
+void MainWindow::on_showDensityRadioButton_clicked()
+{
+    scheduleGraph();
 }
 
 
@@ -705,9 +2105,12 @@ void MainWindow::on_dataTreeWidget_itemChanged(QTreeWidgetItem *item, int column
     Q_UNUSED(item)
     if ((treeitem_change_enabled) && (column == 0)) {
         treeitem_change_enabled = false;
-        getNewOptimalPoints();
+        // Against a golden front the scores do not depend on the other methods
+        if (golden_front.isEmpty()) {
+            getNewOptimalPoints();
+        }
         analyseData();
-        updateGraph();
+        scheduleGraph();
 
         checkall_checkbox_change_enabled = false;
         int check_cnt = 0;
@@ -739,9 +2142,12 @@ void MainWindow::on_checkAllCheckBox_stateChanged(int state)
             itm_parent.at(i)->setCheckState(0, static_cast<Qt::CheckState>(state));
         }
 
-        getNewOptimalPoints();
+        // Against a golden front the scores do not depend on the other methods
+        if (golden_front.isEmpty()) {
+            getNewOptimalPoints();
+        }
         analyseData();
-        updateGraph();
+        scheduleGraph();
         treeitem_change_enabled = true;
     }
 }
@@ -750,6 +2156,11 @@ void MainWindow::on_checkAllCheckBox_stateChanged(int state)
 void MainWindow::on_xAxisList_activated(const QString &arg1)
 {
     x_var = arg1;
+    loadHyperVolumeReference();
+    if (!golden_file.isEmpty() && !loadGoldenFront()) {
+        golden_file.clear();
+        golden_front.clear();
+    }
     resetData();
     QString filename = ui->fileNameLabel->text();
     updateData(filename);
@@ -760,6 +2171,11 @@ void MainWindow::on_xAxisList_activated(const QString &arg1)
 void MainWindow::on_yAxisList_activated(const QString &arg1)
 {
     y_var = arg1;
+    loadHyperVolumeReference();
+    if (!golden_file.isEmpty() && !loadGoldenFront()) {
+        golden_file.clear();
+        golden_front.clear();
+    }
     resetData();
     QString filename = ui->fileNameLabel->text();
     updateData(filename);
@@ -784,7 +2200,7 @@ void MainWindow::on_xAxisLogCheck_toggled(bool checked)
         ui->dataPlot->xAxis->setNumberFormat("f");
         ui->dataPlot->xAxis->setRangeLower(0);
     }
-    updateGraph();
+    scheduleGraph();
 }
 
 void MainWindow::on_yAxisLogCheck_toggled(bool checked)
@@ -804,5 +2220,75 @@ void MainWindow::on_yAxisLogCheck_toggled(bool checked)
         ui->dataPlot->xAxis->setNumberFormat("f");
         ui->dataPlot->yAxis->setRangeLower(0);
     }
-    updateGraph();
+    scheduleGraph();
+}
+
+void MainWindow::on_hvReferenceLineEdit_editingFinished()
+{
+    QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+    settings.setValue("hvReference/" + x_var + "_" + y_var, ui->hvReferenceLineEdit->text().trimmed());
+
+    analyseData();
+}
+
+void MainWindow::indicatorToggled()
+{
+    QStringList indicators;
+    for (int k = 0; k < indicator_actions.size(); k++) {
+        if (indicator_actions.at(k)->isChecked()) {
+            indicators << FrontMetrics::indicatorName(k);
+        }
+    }
+
+    QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+    settings.setValue("indicators", indicators);
+
+    analyseData();
+}
+
+void MainWindow::on_anytimeMetricList_activated(int index)
+{
+    Q_UNUSED(index)
+    updateAnytimeGraph();
+}
+
+void MainWindow::on_anytimeStrideSpin_valueChanged(int stride)
+{
+    QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+    settings.setValue("anytimeStride", stride);
+
+    anytime_cancel->fetchAndStoreRelaxed(1);
+    anytime_curves.clear();
+    updateAnytimeCurves();
+}
+
+void MainWindow::dataSortChanged()
+{
+    sortDesignRows(0);
+}
+
+/*
+ *     Sort the designs under the methods from first_method on by the
+ *     column of the sort indicator, if any
+ */
+void MainWindow::sortDesignRows(int first_method)
+{
+    const QHeaderView *header = ui->dataTreeWidget->header();
+    if (header->sortIndicatorSection() < 0) {
+        return;
+    }
+
+    for (int i = first_method; i < itm_parent.size(); i++) {
+        itm_parent.at(i)->sortChildren(header->sortIndicatorSection(), header->sortIndicatorOrder());
+    }
+}
+
+void MainWindow::pointSizeTriggered(QAction *action)
+{
+    point_size_mode = action->data().toInt();
+
+    QSettings settings(m_sSettingsFile, QSettings::IniFormat);
+    settings.setValue("pointSize", point_size_mode);
+
+    scheduleGraph();
 }
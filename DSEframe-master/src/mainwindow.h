@@ -6,8 +6,27 @@
 #include <QObject>
 #include <QtCore>
 #include <QProcess>
+#include <QActionGroup>
+#include <QFutureWatcher>
 
 #include "qcustomplot.h"
+#include "hypervolume.h"
+#include "hvestimator.h"
+#include "designstore.h"
+#include "paretofront.h"
+#include "metriccache.h"
+#include "anytimecurves.h"
+#include "datatreeitem.h"
+#include "bootstrap.h"
+#include "metrictask.h"
+#include "densitymap.h"
+#include "pointindex.h"
+#include "pointpyramid.h"
+#include "groupscatter.h"
+#include "groupfronts.h"
+#include "grouplegenditem.h"
+#include "scattermatrix.h"
+#include "parallelcoords.h"
 
 namespace Ui {
 class MainWindow;
@@ -21,12 +40,26 @@ public:
     explicit MainWindow(QWidget *parent = 0);
     ~MainWindow();
 
+    static QColor methodColor(int method_n);
+
 private:
 
     void loadSettings();
 
     void saveSettings();
 
+    void loadHyperVolumeReference();
+
+    QPointF hyperVolumeReference();
+
+    QVector< int > hyperVolumeObjectives();
+
+    bool loadGoldenFront();
+
+    const QVector< QPointF > &referenceFront() const;
+
+    double referenceHyperVolume() const;
+
 private slots:
 
     void on_actionNew_File_triggered();
@@ -39,6 +72,24 @@ private slots:
 
     void on_actionAbout_triggered();
 
+    void on_actionEstimate_HyperVolume_triggered();
+
+    void on_actionAnytime_Curves_toggled(bool checked);
+
+    void on_actionScatter_Matrix_triggered();
+
+    void on_actionParallel_Coordinates_triggered();
+
+    void updateDesignViews();
+
+    void scheduleDesignViews();
+
+    void matrixColumnsChanged(const QStringList &names);
+
+    void on_actionLoad_Reference_Front_triggered();
+
+    void on_actionClear_Reference_Front_triggered();
+
     void on_runButton_clicked();
 
     void on_stopButton_clicked();
@@ -61,29 +112,103 @@ private slots:
 
     void analyseData();
 
+    void metricsFinished();
+
+    void bootstrapFinished();
+
+    void hyperVolumeEstimated();
+
+    void anytimeFinished();
+
+    bool indicatorsEnabled();
+
+    MetricKey metricKey();
+
+    void showMetrics();
+
+    void updateAggregateRows(const QMap< QString, QVector< double > > &adrs_samples, const QMap< QString, QVector< double > > &hv_samples);
+
+    void showAggregateRows();
+
+    QString summaryText(const Bootstrap::Summary &summary);
+
     void getNewOptimalPoints();
 
     double calDominance(int method_n);
 
-    double calADRS(int method_n);
-
     double calHyperVolume(int method_n);
 
+    void rebuildHyperVolume(IncrementalHypervolume &hypervolume, const QVector< QPointF > &front, const QPointF &reference);
+
+    void updateHyperVolume();
+
     void initGraph();
 
     void updateGraph();
 
-    void setGraphData(QVector<QPointF> points, QCPGraph *graph);
+    void scheduleGraph();
+
+    void adaptFrameRate(qint64 replot_time);
+
+    void setGraphData(const QVector<QPointF> &points, QCPGraph *graph);
+
+    void updateBaseLine();
+
+    void streamGraph();
+
+    bool updateDensity();
+
+    void updatePyramids();
+
+    void pyramidsFinished();
+
+    void densityRangeChanged();
+
+    void refreshDensity();
+
+    void invalidatePickIndex();
+
+    void updatePickIndex();
+
+    int pickDesign(const QPoint &pos);
+
+    QString designToolTip(int method_n, int row);
+
+    void showSelection();
+
+    void plotMouseMove(QMouseEvent *event);
+
+    void plotMousePress(QMouseEvent *event);
+
+    void plotMouseRelease(QMouseEvent *event);
+
+    void updateFrontColumns(int method_n, int first, int last);
+
+    void sortDesignRows(int first_method);
+
+    void clearFrontColumns(QTreeWidgetItem *item);
+
+    QVector< double > frontPointSizes(int method_n);
+
+    void initAnytimeGraph();
+
+    void updateAnytimeCurves();
+
+    void updateAnytimeGraph();
 
     void on_showOpRaioButton_clicked();
 
     void on_showAllRadioButton_clicked();
 
+    void on_showDensityRadioButton_clicked();
+
     void on_dataTreeWidget_itemChanged(QTreeWidgetItem *item, int column);
 
+    void on_dataTreeWidget_currentItemChanged(QTreeWidgetItem *current, QTreeWidgetItem *previous);
+
     void on_checkAllCheckBox_stateChanged(int state);
 
-    void toggleGraphVisible(QCPLegend *legend, QCPAbstractLegendItem *item);
+    void toggleGraphVisible(QCPLegend *legend, QCPAbstractLegendItem *item, QMouseEvent *event);
 
     void on_xAxisList_activated(const QString &arg1);
 
@@ -93,6 +218,18 @@ private slots:
 
     void on_yAxisLogCheck_toggled(bool checked);
 
+    void on_hvReferenceLineEdit_editingFinished();
+
+    void indicatorToggled();
+
+    void pointSizeTriggered(QAction *action);
+
+    void dataSortChanged();
+
+    void on_anytimeMetricList_activated(int index);
+
+    void on_anytimeStrideSpin_valueChanged(int stride);
+
 private:
     Ui::MainWindow *ui;
 
@@ -105,10 +242,93 @@ private:
     QFileSystemWatcher *watcher;
 
     QVector< QTreeWidgetItem *> itm_parent;
+    QMap< QString, QTreeWidgetItem *> itm_aggregate;
+
+    QVector< QAction *> indicator_actions;
+    QActionGroup *point_size_group;
 
-    QVector< QPointF > op_points_all;
+    GlobalFront op_points_all;
     QVector< QVector< QPointF > > op_points_local;
+    QVector< int > op_points_local_version;
+    QVector< QVector< int > > op_points_local_rows;
     QVector< QVector< QPointF > > data_points;
+    int data_generation;
+    QVector< QVector< QTreeWidgetItem *> > data_items;
+
+    DesignStore designs;
+
+    GroupScatter *row_scatter;
+    GroupScatter *increment_scatter;
+    GroupFronts *front_set;
+    GroupLegendItem *group_legend;
+    QVector< int > plotted_rows;
+    QVector< int > streamed_rows;
+    int base_global_version;
+    int base_golden_version;
+    double graph_x_max;
+    double graph_y_max;
+    int graph_generation;
+
+    QTimer *frame_timer;
+    QTimer *density_timer;
+    QTimer *design_timer;
+    QElapsedTimer frame_clock;
+    int frame_interval;
+    int frame_budget;
+    int scatter_skip;
+
+    QCPColorMap *density_map;
+    DensityMap::Grid density_grid;
+    QVector< quint32 > density_counts;
+    QVector< int > binned_rows;
+    QVector< bool > binned_checked;
+
+    QVector< QSharedPointer< const PointPyramid > > pyramids;
+    QFutureWatcher< QVector< QSharedPointer< const PointPyramid > > > *pyramid_watcher;
+    int pyramid_generation;
+    int pyramid_launch_generation;
+
+    PointIndex pick_index;
+    QVector< QPair< int, int > > pick_refs;
+    bool pick_index_valid;
+    QPoint press_pos;
+    QCPCurve *selection_curve;
+    int selected_method;
+    int selected_row;
+
+    MetricCache metric_cache;
+    MetricTask::CancelToken metric_cancel;
+    QFutureWatcher< QVector< MetricTask::Job > > *metric_watcher;
+
+    QMap< QString, QVector< double > > bootstrap_adrs;
+    QMap< QString, QVector< double > > bootstrap_hv;
+    QStringList bootstrap_methods;
+    QMap< QString, QPair< Bootstrap::Summary, Bootstrap::Summary > > bootstrap_summaries;
+    MetricTask::CancelToken bootstrap_cancel;
+    QFutureWatcher< QVector< Bootstrap::Summary > > *bootstrap_watcher;
+
+    QStringList hv_estimate_methods;
+    MetricTask::CancelToken hv_estimate_cancel;
+    QFutureWatcher< HypervolumeEstimator::Comparison > *hv_estimate_watcher;
+
+    QVector< IncrementalHypervolume > hv_local;
+    IncrementalHypervolume hv_all;
+    QPointF hv_default_reference;
+    bool hv_default_valid;
+
+    QString golden_file;
+    QVector< QPointF > golden_front;
+    IncrementalHypervolume hv_golden;
+    int golden_version;
+
+    ScatterMatrix *scatter_matrix;
+    ParallelCoordinates *parallel_coordinates;
+
+    QVector< AnytimeCurve > anytime_curves;
+    AnytimeCurves::Reference anytime_reference;
+    bool anytime_pending;
+    MetricTask::CancelToken anytime_cancel;
+    QFutureWatcher< QVector< AnytimeCurve > > *anytime_watcher;
 
     QString x_var;
     QString y_var;
@@ -116,6 +336,14 @@ private:
     double x_max;
     double y_max;
 
+    double hv_margin;
+    double hv_accuracy;
+    quint64 hv_seed;
+    int bootstrap_resamples;
+
+    int point_size_mode;
+    int contribution_column;
+
     int data_line_cnt;
 
     bool treeitem_change_enabled;
@@ -0,0 +1,10 @@
+#include "metriccache.h"
+
+const MetricRecord *MetricCache::find(int method, const MetricKey &key) const
+{
+    QHash< int, MetricRecord >::const_iterator it = records.constFind(method);
+    if ((it == records.constEnd()) || !(it.value().key == key)) {
+        return 0;
+    }
+    return &it.value();
+}
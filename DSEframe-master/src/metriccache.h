@@ -0,0 +1,56 @@
+#ifndef METRICCACHE_H
+#define METRICCACHE_H
+
+#include <QHash>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+/*
+ *     Last computed metrics of every method
+ *
+ *     A record stays valid as long as the fronts it was computed from are
+ *     unchanged (same versions), on the same axes, with the same
+ *     hypervolume reference point and the same golden reference front.
+ */
+struct MetricKey
+{
+    int global_version;
+    int local_version;
+    int golden_version;
+    QString axes;
+    QPointF reference;
+
+    bool operator==(const MetricKey &other) const
+    {
+        return (global_version == other.global_version) && (local_version == other.local_version) &&
+               (golden_version == other.golden_version) && (axes == other.axes) &&
+               (reference.x() == other.reference.x()) && (reference.y() == other.reference.y());
+    }
+};
+
+struct MetricRecord
+{
+    MetricKey key;
+    double adrs;
+    double dominance;
+    double hypervolume;
+    QVector< double > indicators;
+};
+
+class MetricCache
+{
+public:
+    void clear() { records.clear(); }
+
+    const MetricRecord *find(int method, const MetricKey &key) const;
+
+    void insert(int method, const MetricRecord &record) { records.insert(method, record); }
+
+    void remove(int method) { records.remove(method); }
+
+private:
+    QHash< int, MetricRecord > records;
+};
+
+#endif // METRICCACHE_H
@@ -0,0 +1,50 @@
+#include "metrictask.h"
+
+#include <QtConcurrent>
+
+namespace {
+
+void runJob(MetricTask::Job &job)
+{
+    job.done = false;
+    if (job.cancelled->loadAcquire()) return;
+
+    if (job.need_adrs) {
+        job.record.adrs = FrontMetrics::adrs(job.front, *job.reference);
+    }
+    if (job.need_dominance) {
+        job.record.dominance = FrontMetrics::dominance(job.front, *job.reference_keys);
+    }
+    if (job.need_indicators) {
+        job.record.indicators = FrontMetrics::indicators(job.front, *job.reference);
+    }
+    job.done = true;
+}
+
+}
+
+QVector< MetricTask::Job > MetricTask::run(QVector< Job > jobs, QVector< QPointF > reference, CancelToken cancelled)
+{
+    // The reference is hashed once for every method that needs dominance
+    bool need_keys = false;
+    for (int i = 0; i < jobs.size(); i++) {
+        need_keys = need_keys || jobs[i].need_dominance;
+    }
+    const FrontMetrics::PointSet reference_keys = need_keys ? FrontMetrics::pointSet(reference) : FrontMetrics::PointSet();
+
+    for (int i = 0; i < jobs.size(); i++) {
+        jobs[i].reference = &reference;
+        jobs[i].reference_keys = &reference_keys;
+        jobs[i].cancelled = cancelled.data();
+    }
+    QtConcurrent::blockingMap(jobs, runJob);
+
+    QVector< Job > finished;
+    for (int i = 0; i < jobs.size(); i++) {
+        if (jobs[i].done) {
+            finished.append(jobs[i]);
+        }
+    }
+
+    return finished;
+}
@@ -0,0 +1,43 @@
+#ifndef METRICTASK_H
+#define METRICTASK_H
+
+#include <QVector>
+#include <QPointF>
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+#include "metriccache.h"
+#include "frontmetrics.h"
+
+/*
+ *     Background computation of the metrics the cache is missing
+ *
+ *     Each job carries a copy of a method's front and the values already
+ *     known on the GUI thread; run() fills in the rest, one method per pool
+ *     thread. Once the token is set, jobs that have not started are
+ *     skipped and only finished jobs are returned.
+ */
+namespace MetricTask {
+
+typedef QSharedPointer< QAtomicInt > CancelToken;
+
+struct Job
+{
+    int method;
+    MetricRecord record;
+    QVector< QPointF > front;
+    bool need_adrs;
+    bool need_dominance;
+    bool need_indicators;
+
+    const QVector< QPointF > *reference;
+    const FrontMetrics::PointSet *reference_keys;
+    const QAtomicInt *cancelled;
+    bool done;
+};
+
+QVector< Job > run(QVector< Job > jobs, QVector< QPointF > reference, CancelToken cancelled);
+
+}
+
+#endif // METRICTASK_H
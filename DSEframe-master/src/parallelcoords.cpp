@@ -0,0 +1,538 @@
+#include "parallelcoords.h"
+
+#include <QPainter>
+#include <QMouseEvent>
+#include <QtConcurrent>
+
+#include <math.h>
+
+namespace {
+
+// space around the axes for their names and ranges, in pixels
+const int margin_x = 40;
+const int margin_y = 24;
+
+// half width of the band around an axis that starts a brush
+const int axis_grab = 8;
+
+// axis pixels are counted in pairs of at most this many bins per axis
+const int max_bins = 256;
+
+const QColor row_color(30, 60, 150);
+const QColor brushed_color(220, 20, 60);
+
+/*
+ *     Add weight to the pixels of the line from (0, y0) to (width - 1, y1)
+ *
+ *     The line is stepped one pixel at a time along its longer side, per
+ *     column when it is flat and per row when it is steep, so it leaves no
+ *     gaps; each step splits the weight between the two pixels nearest to
+ *     the line across it.
+ */
+void addLine(float *density, int width, int height, double y0, double y1, float weight)
+{
+    const int last_x = qMax(width - 1, 1);
+    if (qAbs(y1 - y0) <= last_x) {
+        const double slope = (y1 - y0) / last_x;
+        for (int x = 0; x < width; x++) {
+            const double y = y0 + slope * x;
+            const int iy = qMin(int(y), height - 1);
+            const float f = float(y - iy);
+            density[iy * width + x] += weight * (1.0f - f);
+            if (iy + 1 < height) {
+                density[(iy + 1) * width + x] += weight * f;
+            }
+        }
+        return;
+    }
+
+    const int first_y = int(qMin(y0, y1) + 0.5);
+    const int last_y = qMin(int(qMax(y0, y1) + 0.5), height - 1);
+    const double inverse_slope = last_x / (y1 - y0);
+    for (int y = first_y; y <= last_y; y++) {
+        const double x = qBound(0.0, (y - y0) * inverse_slope, double(last_x));
+        const int ix = qMin(int(x), width - 1);
+        const float f = float(x - ix);
+        density[y * width + ix] += weight * (1.0f - f);
+        if (ix + 1 < width) {
+            density[y * width + ix + 1] += weight * f;
+        }
+    }
+}
+
+}
+
+ParallelCoordinates::ParallelCoordinates(QWidget *parent) :
+    QWidget(parent, Qt::Window),
+    visible_version(0),
+    ranged_rows(0),
+    layout_version(0),
+    brush_axis(-1),
+    brush_origin(0),
+    selected_cnt(0),
+    selection_version(0)
+{
+    strip_watcher = new QFutureWatcher< QVector< StripJob > >(this);
+    connect(strip_watcher, SIGNAL(finished()), this, SLOT(stripsFinished()));
+
+    setMinimumSize(300, 200);
+}
+
+ParallelCoordinates::~ParallelCoordinates()
+{
+    strip_watcher->waitForFinished();
+}
+
+/*
+ *     Plot the rows of the visible groups
+ *
+ *     A copy of the store is kept for the render tasks, which is cheap as
+ *     its column blocks are shared. While the rows only grew, the column
+ *     ranges and the count of visible rows are grown by the new rows and
+ *     the strips keep their pair counts.
+ */
+void ParallelCoordinates::setDesigns(const DesignStore &designs, const QVector< bool > &visible)
+{
+    const bool appended = source && (designs.generation() == source->designs.generation()) &&
+                          (designs.rowCount() >= ranged_rows) && (visible == source->visible);
+    const int visible_cnt = appended ? source->visible_cnt : 0;
+    if (!appended) {
+        visible_version++;
+        ranged_rows = 0;
+        column_low.clear();
+        column_high.clear();
+    }
+
+    Source *data = new Source;
+    data->designs = designs;
+    data->visible = visible;
+    data->visible_cnt = visible_cnt + designs.extendRanges(visible, ranged_rows, column_low, column_high);
+    source = QSharedPointer< const Source >(data);
+    ranged_rows = designs.rowCount();
+
+    updateAxes();
+    updateSelection();
+    render();
+    update();
+}
+
+/*
+ *     One axis per numeric column except Method, Iteration and ATTR, over
+ *     the range of the visible rows
+ */
+void ParallelCoordinates::updateAxes()
+{
+    const QVector< int > last_columns = axis_columns;
+    axis_columns.clear();
+    axis_low.clear();
+    axis_high.clear();
+
+    const DesignStore &designs = source->designs;
+    for (int column = 0; column < designs.columnCount(); column++) {
+        const QString name = designs.columnNames().at(column);
+        if (!designs.isNumeric(column) || (name == "Method") || (name == "Iteration") || (name == "ATTR")) continue;
+
+        double low = column_low.value(column, qInf());
+        double high = column_high.value(column, -qInf());
+        if (low > high) {
+            low = 0.0;
+            high = 1.0;
+        }
+        else if (low == high) {
+            low -= 0.5;
+            high += 0.5;
+        }
+
+        axis_columns.append(column);
+        axis_low.append(low);
+        axis_high.append(high);
+    }
+
+    // Other columns start over; new ranges keep the old images on screen
+    // until theirs are rendered
+    if (axis_columns != last_columns) {
+        const View none = { 0.0, 0.0, 0.0, 0.0, QSize(), -1 };
+        Strip empty;
+        empty.view = none;
+        empty.rows = 0;
+        empty.overlay_version = -1;
+        strips.fill(empty, qMax(axis_columns.size() - 1, 0));
+        axis_brush.fill(qMakePair(qInf(), -qInf()), axis_columns.size());
+        brush_axis = -1;
+        layout_version++;
+    }
+}
+
+/*
+ *     Select the visible rows inside the range of every brushed axis
+ *
+ *     Each predicate builds a word of 64 results without branches and
+ *     clears the rows it fails in the bitset; words already empty are
+ *     skipped.
+ */
+void ParallelCoordinates::updateSelection()
+{
+    selection_version++;
+
+    bool brushed = false;
+    for (int k = 0; k < axis_brush.size(); k++) {
+        brushed = brushed || (axis_brush[k].first <= axis_brush[k].second);
+    }
+    if (!source || !brushed) {
+        selection.clear();
+        selected_cnt = 0;
+        return;
+    }
+
+    const DesignStore &designs = source->designs;
+    const int row_cnt = designs.rowCount();
+    const int word_cnt = (row_cnt + 63) / 64;
+
+    // A block holds a whole number of words, so a word never spans two
+    const int block_words = DesignStore::block_rows / 64;
+
+    QVector< quint64 > *bits = new QVector< quint64 >(word_cnt, 0);
+    quint64 *words = bits->data();
+    for (int b = 0; b < designs.blockCount(); b++) {
+        const QVector< int > &groups = designs.groupBlock(b);
+        quint64 *block = words + b * block_words;
+        for (int i = 0; i < groups.size(); i++) {
+            block[i >> 6] |= quint64(source->visible.value(groups[i]) ? 1 : 0) << (i & 63);
+        }
+    }
+    for (int k = 0; k < axis_brush.size(); k++) {
+        const double low = axis_brush[k].first;
+        const double high = axis_brush[k].second;
+        if (low > high) continue;
+
+        for (int w = 0; w < word_cnt; w++) {
+            if (words[w] == 0) continue;
+
+            const double *values = designs.columnBlock(axis_columns[k], w / block_words).constData() + (w % block_words) * 64;
+            const int cnt = qMin(64, row_cnt - w * 64);
+            quint64 word = 0;
+            for (int b = 0; b < cnt; b++) {
+                word |= quint64((values[b] >= low) & (values[b] <= high)) << b;
+            }
+            words[w] &= word;
+        }
+    }
+
+    selected_cnt = 0;
+    for (int w = 0; w < word_cnt; w++) {
+        selected_cnt += qPopulationCount(words[w]);
+    }
+    selection = QSharedPointer< const QVector< quint64 > >(bits);
+}
+
+/*
+ *     Start rendering the strips whose images are out of date
+ *
+ *     A strip counts its rows again from the first one when its view
+ *     changed, otherwise only the rows it has not counted yet are added to
+ *     a copy of its pair counts. One batch runs at a time; the next one is
+ *     started when it finishes.
+ */
+void ParallelCoordinates::render()
+{
+    if (strip_watcher->isRunning() || !source) {
+        return;
+    }
+
+    const int n = axis_columns.size();
+    const QSize size(axisX(1) - axisX(0), plotRect().height());
+    if ((n < 2) || size.isEmpty()) {
+        return;
+    }
+
+    const int row_cnt = source->designs.rowCount();
+    QVector< StripJob > jobs;
+    for (int k = 0; k + 1 < n; k++) {
+        const Strip &strip = strips[k];
+        StripJob job;
+        job.strip = k;
+        job.layout = layout_version;
+        job.version = 0;
+        job.overlay = false;
+        job.left_column = axis_columns[k];
+        job.right_column = axis_columns[k + 1];
+        job.view.left_low = axis_low[k];
+        job.view.left_high = axis_high[k];
+        job.view.right_low = axis_low[k + 1];
+        job.view.right_high = axis_high[k + 1];
+        job.view.size = size;
+        job.view.visible_version = visible_version;
+        job.first_row = 0;
+        job.last_row = row_cnt;
+        job.source = source;
+
+        if (!(strip.view == job.view)) {
+            jobs.append(job);
+        }
+        else if (strip.rows < row_cnt) {
+            StripJob append = job;
+            append.first_row = strip.rows;
+            append.pair_counts = strip.pair_counts;
+            jobs.append(append);
+        }
+        if (selection && (strip.overlay_version != selection_version)) {
+            job.version = selection_version;
+            job.overlay = true;
+            job.selection = selection;
+            jobs.append(job);
+        }
+    }
+
+    if (!jobs.isEmpty()) {
+        strip_watcher->setFuture(QtConcurrent::run(ParallelCoordinates::renderStrips, jobs));
+    }
+}
+
+/*
+ *     Show the rendered images, then render what changed meanwhile; an
+ *     image of an older view or brush is still newer than the one shown.
+ *     Rows added to counts only apply to those counts.
+ */
+void ParallelCoordinates::stripsFinished()
+{
+    const QVector< StripJob > jobs = strip_watcher->result();
+    for (int k = 0; k < jobs.size(); k++) {
+        if (jobs[k].layout != layout_version) continue;
+
+        Strip &strip = strips[jobs[k].strip];
+        if (!jobs[k].overlay && ((jobs[k].first_row == 0) || ((strip.view == jobs[k].view) && (strip.rows == jobs[k].first_row)))) {
+            strip.base = jobs[k].image;
+            strip.view = jobs[k].view;
+            strip.rows = jobs[k].last_row;
+            strip.pair_counts = jobs[k].pair_counts;
+        }
+        else if (jobs[k].overlay && (jobs[k].version > strip.overlay_version)) {
+            strip.overlay = jobs[k].image;
+            strip.overlay_version = jobs[k].version;
+        }
+    }
+
+    render();
+    update();
+}
+
+QVector< ParallelCoordinates::StripJob > ParallelCoordinates::renderStrips(QVector< StripJob > jobs)
+{
+    QtConcurrent::blockingMap(jobs, ParallelCoordinates::renderStrip);
+    return jobs;
+}
+
+/*
+ *     Density of the polylines of rows first_row..last_row between two
+ *     axes, or of their brushed rows
+ *
+ *     Rows are counted per pair of bins on the two axes, so the cost of
+ *     drawing depends on the pairs in use rather than on the rows, and
+ *     rows added to the counts of a strip cost nothing more. The line of
+ *     each pair adds its count to every pixel it crosses, and the sum is
+ *     shown with an alpha on a log scale of the visible rows, the same in
+ *     every strip.
+ */
+void ParallelCoordinates::renderStrip(StripJob &job)
+{
+    const DesignStore &designs = job.source->designs;
+    const quint64 *brushed = job.overlay ? job.selection->constData() : 0;
+
+    const int width = job.view.size.width();
+    const int height = job.view.size.height();
+    const int bins = qMax(qMin(height, max_bins), 2);
+    const double left_scale = (bins - 1) / (job.view.left_high - job.view.left_low);
+    const double right_scale = (bins - 1) / (job.view.right_high - job.view.right_low);
+
+    if (job.first_row == 0) {
+        job.pair_counts.fill(0, bins * bins);
+    }
+
+    quint32 *pair_counts = job.pair_counts.data();
+    for (int block = job.first_row / DesignStore::block_rows; block < designs.blockCount(); block++) {
+        const double *left_values = designs.columnBlock(job.left_column, block).constData();
+        const double *right_values = designs.columnBlock(job.right_column, block).constData();
+        const QVector< int > &groups = designs.groupBlock(block);
+        const int base = block * DesignStore::block_rows;
+        if (base >= job.last_row) break;
+
+        const int last = qMin(job.last_row - base, groups.size());
+        for (int i = qMax(job.first_row - base, 0); i < last; i++) {
+            const int row = base + i;
+            if (brushed ? !((brushed[row >> 6] >> (row & 63)) & 1) : !job.source->visible.value(groups[i])) continue;
+            if (!qIsFinite(left_values[i]) || !qIsFinite(right_values[i])) continue;
+
+            const int a = qBound(0, int((job.view.left_high - left_values[i]) * left_scale + 0.5), bins - 1);
+            const int b = qBound(0, int((job.view.right_high - right_values[i]) * right_scale + 0.5), bins - 1);
+            pair_counts[a * bins + b]++;
+        }
+    }
+
+    QVector< float > density(width * height, 0.0f);
+    const double bin_height = double(height - 1) / (bins - 1);
+    for (int a = 0; a < bins; a++) {
+        for (int b = 0; b < bins; b++) {
+            const quint32 count = pair_counts[a * bins + b];
+            if (count == 0) continue;
+
+            addLine(density.data(), width, height, a * bin_height, b * bin_height, count);
+        }
+    }
+
+    const QColor color = job.overlay ? brushed_color : row_color;
+    const double log_total = log1p(qMax(job.source->visible_cnt, 1));
+    job.image = QImage(job.view.size, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; y++) {
+        QRgb *line = reinterpret_cast< QRgb *>(job.image.scanLine(y));
+        for (int x = 0; x < width; x++) {
+            const float d = density[y * width + x];
+            if (d < 0.05f) {
+                line[x] = 0;
+                continue;
+            }
+            const int alpha = qMin(255, int(255 * (0.15 + 0.85 * log1p(d) / log_total)));
+            line[x] = qPremultiply(qRgba(color.red(), color.green(), color.blue(), alpha));
+        }
+    }
+}
+
+QRect ParallelCoordinates::plotRect() const
+{
+    return rect().adjusted(margin_x, margin_y, -margin_x, -margin_y);
+}
+
+int ParallelCoordinates::axisX(int k) const
+{
+    const QRect plot_rect = plotRect();
+    return plot_rect.left() + k * plot_rect.width() / qMax(axis_columns.size() - 1, 1);
+}
+
+int ParallelCoordinates::axisAt(const QPoint &pos) const
+{
+    if ((pos.y() < plotRect().top()) || (pos.y() > plotRect().bottom())) {
+        return -1;
+    }
+    for (int k = 0; k < axis_columns.size(); k++) {
+        if (qAbs(pos.x() - axisX(k)) <= axis_grab) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+void ParallelCoordinates::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    const int n = axis_columns.size();
+    if (n < 2) {
+        painter.drawText(rect(), Qt::AlignCenter, tr("At least two numeric columns are needed"));
+        return;
+    }
+
+    const QRect plot_rect = plotRect();
+    for (int k = 0; k + 1 < n; k++) {
+        // Images of another size are stretched until their rerender
+        const QRect strip_rect(axisX(k), plot_rect.top(), axisX(k + 1) - axisX(k), plot_rect.height());
+        if (!strips[k].base.isNull()) {
+            painter.setOpacity(selection ? 0.3 : 1.0);
+            painter.drawImage(strip_rect, strips[k].base);
+            painter.setOpacity(1.0);
+        }
+        if (selection && !strips[k].overlay.isNull()) {
+            painter.drawImage(strip_rect, strips[k].overlay);
+        }
+    }
+
+    const QFontMetrics metrics = painter.fontMetrics();
+    for (int k = 0; k < n; k++) {
+        const int x = axisX(k);
+        const double y_scale = plot_rect.height() / (axis_high[k] - axis_low[k]);
+
+        if (axis_brush[k].first <= axis_brush[k].second) {
+            painter.fillRect(QRectF(x - axis_grab / 2, plot_rect.top() + (axis_high[k] - axis_brush[k].second) * y_scale,
+                                    axis_grab, (axis_brush[k].second - axis_brush[k].first) * y_scale),
+                             QColor(brushed_color.red(), brushed_color.green(), brushed_color.blue(), 120));
+        }
+
+        painter.setPen(Qt::black);
+        painter.drawLine(x, plot_rect.top(), x, plot_rect.bottom());
+        const QString name = source->designs.columnNames().at(axis_columns[k]);
+        painter.drawText(x - metrics.boundingRect(name).width() / 2, plot_rect.top() - metrics.descent() - 4, name);
+
+        // The top of an axis is its largest value
+        painter.setPen(Qt::gray);
+        const QString high = QString::number(axis_high[k], 'g', 4);
+        const QString low = QString::number(axis_low[k], 'g', 4);
+        painter.drawText(x + 3, plot_rect.top() + metrics.ascent(), high);
+        painter.drawText(x - metrics.boundingRect(low).width() / 2, plot_rect.bottom() + metrics.ascent() + 2, low);
+    }
+
+    if (selection) {
+        painter.setPen(brushed_color);
+        painter.drawText(rect().adjusted(4, 2, -4, 0), Qt::AlignRight | Qt::AlignTop,
+                         tr("%1 of %2 designs").arg(selected_cnt).arg(source->visible_cnt));
+    }
+}
+
+void ParallelCoordinates::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    // Cached images keep being shown, stretched, until the new ones arrive;
+    // the base images are rendered again as their size is part of the view
+    selection_version++;
+    render();
+}
+
+void ParallelCoordinates::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) {
+        return;
+    }
+
+    brush_axis = axisAt(event->pos());
+    brush_origin = event->pos().y();
+}
+
+/*
+ *     Brush the range of the axis between the press and the cursor
+ */
+void ParallelCoordinates::mouseMoveEvent(QMouseEvent *event)
+{
+    if (brush_axis < 0) {
+        return;
+    }
+
+    const QRect plot_rect = plotRect();
+    const int y0 = qBound(plot_rect.top(), qMin(brush_origin, event->pos().y()), plot_rect.bottom());
+    const int y1 = qBound(plot_rect.top(), qMax(brush_origin, event->pos().y()), plot_rect.bottom());
+    const double scale = (axis_high[brush_axis] - axis_low[brush_axis]) / plot_rect.height();
+    axis_brush[brush_axis] = qMakePair(axis_high[brush_axis] - (y1 - plot_rect.top()) * scale,
+                                       axis_high[brush_axis] - (y0 - plot_rect.top()) * scale);
+
+    updateSelection();
+    render();
+    update();
+}
+
+/*
+ *     A click on an axis without a drag clears its brush
+ */
+void ParallelCoordinates::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (brush_axis < 0) {
+        return;
+    }
+
+    if (qAbs(event->pos().y() - brush_origin) < 3) {
+        axis_brush[brush_axis] = qMakePair(qInf(), -qInf());
+        updateSelection();
+        render();
+        update();
+    }
+    brush_axis = -1;
+}
@@ -0,0 +1,141 @@
+#ifndef PARALLELCOORDS_H
+#define PARALLELCOORDS_H
+
+#include <QWidget>
+#include <QImage>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+
+#include "designstore.h"
+
+/*
+ *     Parallel coordinates of every numeric column of the design store
+ *
+ *     Each row is a polyline over one vertical axis per column. Rows are
+ *     not drawn one by one: between two axes they are counted per pair of
+ *     axis pixels, and the line of each pair adds its count to a density
+ *     image, shown on a log scale. The strips between axes are rendered on
+ *     the thread pool and keep their pair counts until the range of one of
+ *     their axes, the visible groups or the size change; rows appended
+ *     meanwhile are only added to the counts, and the ranges are grown by
+ *     the new rows only.
+ *
+ *     Dragging along an axis brushes a range of it. A row is selected when
+ *     it lies in the range of every brushed axis; the predicates fill a
+ *     bitset a word of 64 rows at a time, and only the selected rows are
+ *     rendered again, over the faded density of all rows.
+ */
+class ParallelCoordinates : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ParallelCoordinates(QWidget *parent = 0);
+    ~ParallelCoordinates();
+
+    void setDesigns(const DesignStore &designs, const QVector< bool > &visible);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+    void resizeEvent(QResizeEvent *event) override;
+
+    void mousePressEvent(QMouseEvent *event) override;
+
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private slots:
+    void stripsFinished();
+
+private:
+    struct Source
+    {
+        DesignStore designs;
+        QVector< bool > visible;
+        int visible_cnt;
+    };
+
+    struct View
+    {
+        double left_low;
+        double left_high;
+        double right_low;
+        double right_high;
+        QSize size;
+        int visible_version;
+
+        bool operator==(const View &other) const
+        {
+            return (left_low == other.left_low) && (left_high == other.left_high) && (right_low == other.right_low) &&
+                   (right_high == other.right_high) && (size == other.size) && (visible_version == other.visible_version);
+        }
+    };
+
+    struct Strip
+    {
+        QImage base;
+        View view;
+        int rows;
+        QVector< quint32 > pair_counts;
+
+        QImage overlay;
+        int overlay_version;
+    };
+
+    struct StripJob
+    {
+        int strip;
+        int layout;
+        int version;
+        bool overlay;
+        int left_column;
+        int right_column;
+        View view;
+        int first_row;
+        int last_row;
+        QSharedPointer< const Source > source;
+        QSharedPointer< const QVector< quint64 > > selection;
+        QImage image;
+        QVector< quint32 > pair_counts;
+    };
+
+    static QVector< StripJob > renderStrips(QVector< StripJob > jobs);
+
+    static void renderStrip(StripJob &job);
+
+    void updateAxes();
+
+    void updateSelection();
+
+    void render();
+
+    QRect plotRect() const;
+
+    int axisX(int k) const;
+
+    int axisAt(const QPoint &pos) const;
+
+    QSharedPointer< const Source > source;
+    int visible_version;
+    int ranged_rows;
+    QVector< double > column_low;
+    QVector< double > column_high;
+    QVector< int > axis_columns;
+    QVector< double > axis_low;
+    QVector< double > axis_high;
+    QVector< QPair< double, double > > axis_brush;
+
+    QVector< Strip > strips;
+    int layout_version;
+    QFutureWatcher< QVector< StripJob > > *strip_watcher;
+
+    int brush_axis;
+    int brush_origin;
+    QSharedPointer< const QVector< quint64 > > selection;
+    int selected_cnt;
+    int selection_version;
+};
+
+#endif // PARALLELCOORDS_H
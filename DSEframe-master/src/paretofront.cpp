@@ -0,0 +1,286 @@
+#include "paretofront.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+bool lessXY(const QPointF &a, const QPointF &b)
+{
+    return (a.x() < b.x()) || ((a.x() == b.x()) && (a.y() < b.y()));
+}
+
+bool lessX(const QPointF &a, double x)
+{
+    return a.x() < x;
+}
+
+struct MergeTask
+{
+    const QVector< QPointF > *front_a;
+    const QVector< QPointF > *front_b;
+    QVector< QPointF > result;
+};
+
+void runMergeTask(MergeTask &task)
+{
+    task.result = ParetoFront::merge(*task.front_a, *task.front_b);
+}
+
+}
+
+/*
+ *     Insert one point into a sorted front, removing the points it dominates
+ *
+ *     On success the position of the point and the number of points it
+ *     evicted (which followed it) are returned through index and evicted.
+ */
+bool ParetoFront::insertPoint(QVector< QPointF > &front, const QPointF &point, int *index, int *evicted)
+{
+    int i;
+    for (i = 0; i < front.size(); i++) {
+        if ((point.y() >= front[i].y()) && (point.x() >= front[i].x())) {
+            return false;
+        }
+        else if (point.x() <= front[i].x()) {
+            break;
+        }
+    }
+
+    // insert by x order and remove points that are no longer optimal
+    front.insert(i, point);
+
+    int k = i + 1;
+    while ((k < front.size()) && (point.y() <= front[k].y())) {
+        k++;
+    }
+    front.remove(i + 1, k - i - 1);
+
+    if (index) {
+        *index = i;
+    }
+    if (evicted) {
+        *evicted = k - i - 1;
+    }
+    return true;
+}
+
+/*
+ *     Build the front of an unordered point set with a sort and a single sweep
+ */
+QVector< QPointF > ParetoFront::build(const QVector< QPointF > &points)
+{
+    QVector< QPointF > sorted = points;
+    std::sort(sorted.begin(), sorted.end(), lessXY);
+
+    QVector< QPointF > front;
+    for (int i = 0; i < sorted.size(); i++) {
+        if (front.isEmpty() || (sorted[i].y() < front.last().y())) {
+            front.append(sorted[i]);
+        }
+    }
+
+    return front;
+}
+
+/*
+ *     Merge two fronts into the front of their union in linear time
+ */
+QVector< QPointF > ParetoFront::merge(const QVector< QPointF > &front_a, const QVector< QPointF > &front_b)
+{
+    QVector< QPointF > front;
+    front.reserve(front_a.size() + front_b.size());
+
+    int i = 0;
+    int j = 0;
+    while ((i < front_a.size()) || (j < front_b.size())) {
+        QPointF point;
+        if ((j == front_b.size()) || ((i < front_a.size()) && lessXY(front_a[i], front_b[j]))) {
+            point = front_a[i++];
+        }
+        else {
+            point = front_b[j++];
+        }
+
+        if (front.isEmpty() || (point.y() < front.last().y())) {
+            front.append(point);
+        }
+    }
+
+    return front;
+}
+
+/*
+ *     Build the front of every point set concurrently, one task per set
+ */
+QVector< QVector< QPointF > > ParetoFront::buildAll(const QVector< QVector< QPointF > > &point_sets)
+{
+    return QtConcurrent::blockingMapped< QVector< QVector< QPointF > > >(point_sets, ParetoFront::build);
+}
+
+/*
+ *     Reduce a list of fronts to the front of their union
+ *
+ *     Fronts are merged pairwise, each level of the reduction tree running
+ *     concurrently, so the depth is log2 of the number of fronts.
+ */
+QVector< QPointF > ParetoFront::mergeAll(const QVector< QVector< QPointF > > &fronts)
+{
+    QVector< QVector< QPointF > > level = fronts;
+
+    while (level.size() > 1) {
+        QVector< MergeTask > tasks(level.size() / 2);
+        for (int i = 0; i < tasks.size(); i++) {
+            tasks[i].front_a = &level[2 * i];
+            tasks[i].front_b = &level[2 * i + 1];
+        }
+        QtConcurrent::blockingMap(tasks, runMergeTask);
+
+        QVector< QVector< QPointF > > next_level;
+        next_level.reserve(tasks.size() + 1);
+        for (int i = 0; i < tasks.size(); i++) {
+            next_level.append(tasks[i].result);
+        }
+        if (level.size() % 2 == 1) {
+            next_level.append(level.last());
+        }
+        level = next_level;
+    }
+
+    return level.isEmpty() ? QVector< QPointF >() : level.first();
+}
+
+/*
+ *     Exclusive hypervolume of front point i: the box between it, its
+ *     neighbours and the reference point that no other point covers
+ */
+double ParetoFront::contribution(const QVector< QPointF > &front, int i, const QPointF &reference)
+{
+    const double right = (i + 1 < front.size()) ? qMin(front[i + 1].x(), reference.x()) : reference.x();
+    const double top = (i > 0) ? qMin(front[i - 1].y(), reference.y()) : reference.y();
+
+    return qMax(right - front[i].x(), 0.0) * qMax(top - front[i].y(), 0.0);
+}
+
+/*
+ *     Crowding distance of front point i: the sides of the box spanned by
+ *     its neighbours, normalized by the extent of the front. The extreme
+ *     points are always kept, so theirs is infinite.
+ */
+double ParetoFront::crowding(const QVector< QPointF > &front, int i)
+{
+    if ((i == 0) || (i == front.size() - 1)) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    const double x_range = front.last().x() - front.first().x();
+    const double y_range = front.first().y() - front.last().y();
+
+    return (front[i + 1].x() - front[i - 1].x()) / x_range + (front[i - 1].y() - front[i + 1].y()) / y_range;
+}
+
+GlobalFront::GlobalFront() :
+    front_version(0)
+{
+}
+
+void GlobalFront::clear()
+{
+    if (!front_points.isEmpty()) {
+        front_version++;
+    }
+    front_points.clear();
+    point_owners.clear();
+    owned_cnt.clear();
+}
+
+/*
+ *     Insert a point of the given owner's front; returns true if the front
+ *     points changed, an equal point only gains an owner
+ */
+bool GlobalFront::insert(const QPointF &point, int owner)
+{
+    int i = std::lower_bound(front_points.constBegin(), front_points.constEnd(), point.x(), lessX) - front_points.constBegin();
+
+    if ((i < front_points.size()) && (front_points[i].x() == point.x()) && (front_points[i].y() <= point.y())) {
+        if (front_points[i].y() == point.y()) {
+            addOwner(i, owner);
+        }
+        return false;
+    }
+    if ((i > 0) && (front_points[i - 1].y() <= point.y())) {
+        return false;
+    }
+
+    int k = i;
+    while ((k < front_points.size()) && (point.y() <= front_points[k].y())) {
+        for (int j = 0; j < point_owners[k].size(); j++) {
+            owned_cnt[point_owners[k][j]]--;
+        }
+        k++;
+    }
+    front_points.remove(i, k - i);
+    point_owners.remove(i, k - i);
+
+    front_points.insert(i, point);
+    point_owners.insert(i, QVector< int >());
+    addOwner(i, owner);
+    front_version++;
+
+    return true;
+}
+
+/*
+ *     Rebuild from the fronts of several owners; the version is kept when
+ *     the resulting points are the same
+ */
+void GlobalFront::build(const QVector< QVector< QPointF > > &fronts, const QVector< int > &front_owners)
+{
+    QVector< QPointF > merged = ParetoFront::mergeAll(fronts);
+
+    bool same = (merged.size() == front_points.size());
+    for (int i = 0; same && (i < merged.size()); i++) {
+        same = (merged[i].x() == front_points[i].x()) && (merged[i].y() == front_points[i].y());
+    }
+    if (!same) {
+        front_points = merged;
+        front_version++;
+    }
+
+    point_owners.clear();
+    point_owners.resize(front_points.size());
+    owned_cnt.clear();
+
+    for (int f = 0; f < fronts.size(); f++) {
+        for (int j = 0; j < fronts[f].size(); j++) {
+            const int i = find(fronts[f][j]);
+            if (i >= 0) {
+                addOwner(i, front_owners[f]);
+            }
+        }
+    }
+}
+
+int GlobalFront::find(const QPointF &point) const
+{
+    int i = std::lower_bound(front_points.constBegin(), front_points.constEnd(), point.x(), lessX) - front_points.constBegin();
+    if ((i < front_points.size()) && (front_points[i].x() == point.x()) && (front_points[i].y() == point.y())) {
+        return i;
+    }
+    return -1;
+}
+
+void GlobalFront::addOwner(int i, int owner)
+{
+    if (point_owners[i].contains(owner)) {
+        return;
+    }
+    point_owners[i].append(owner);
+
+    if (owned_cnt.size() <= owner) {
+        owned_cnt.resize(owner + 1);
+    }
+    owned_cnt[owner]++;
+}
@@ -0,0 +1,74 @@
+#ifndef PARETOFRONT_H
+#define PARETOFRONT_H
+
+#include <QVector>
+#include <QPointF>
+
+/*
+ *     2-D Pareto front helpers
+ *
+ *     A front is kept sorted by increasing x (and therefore decreasing y).
+ *     A point that is equal to, or dominated by, a front member is never
+ *     added, so every front holds each non-dominated value exactly once and
+ *     does not depend on the order in which the points were seen.
+ */
+namespace ParetoFront {
+
+bool insertPoint(QVector< QPointF > &front, const QPointF &point, int *index = 0, int *evicted = 0);
+
+QVector< QPointF > build(const QVector< QPointF > &points);
+
+QVector< QPointF > merge(const QVector< QPointF > &front_a, const QVector< QPointF > &front_b);
+
+QVector< QVector< QPointF > > buildAll(const QVector< QVector< QPointF > > &point_sets);
+
+QVector< QPointF > mergeAll(const QVector< QVector< QPointF > > &fronts);
+
+double contribution(const QVector< QPointF > &front, int i, const QPointF &reference);
+
+double crowding(const QVector< QPointF > &front, int i);
+
+}
+
+/*
+ *     Front of several methods that remembers which methods contributed
+ *     each point
+ *
+ *     A method owns a front point when exactly the same value is on its
+ *     own front. The number of points each method owns is kept up to date
+ *     as points are inserted and evicted. The version changes whenever the
+ *     front points do.
+ */
+class GlobalFront
+{
+public:
+    GlobalFront();
+
+    void clear();
+
+    bool insert(const QPointF &point, int owner);
+
+    void build(const QVector< QVector< QPointF > > &fronts, const QVector< int > &front_owners);
+
+    const QVector< QPointF > &points() const { return front_points; }
+
+    const QVector< int > &owners(int i) const { return point_owners[i]; }
+
+    int size() const { return front_points.size(); }
+
+    int ownedCount(int owner) const { return (owner < owned_cnt.size()) ? owned_cnt[owner] : 0; }
+
+    int version() const { return front_version; }
+
+private:
+    int find(const QPointF &point) const;
+
+    void addOwner(int i, int owner);
+
+    QVector< QPointF > front_points;
+    QVector< QVector< int > > point_owners;
+    QVector< int > owned_cnt;
+    int front_version;
+};
+
+#endif // PARETOFRONT_H
@@ -0,0 +1,138 @@
+#include "pointindex.h"
+
+#include <QtGlobal>
+
+#include <math.h>
+
+namespace {
+
+// keeps the cell table small when the points are spread far apart
+const int max_cells_per_side = 4096;
+
+}
+
+PointIndex::PointIndex() :
+    x_lower(0.0), y_lower(0.0), cell(1.0), nx(0), ny(0)
+{
+}
+
+void PointIndex::clear()
+{
+    nx = 0;
+    ny = 0;
+    cell_begin.clear();
+    cell_points.clear();
+    positions.clear();
+}
+
+/*
+ *     Index a point set; nearest() returns positions in this vector
+ *
+ *     The points are placed with a counting sort over their cells.
+ */
+void PointIndex::build(const QVector< QPointF > &points, double cell_size)
+{
+    clear();
+    positions = points;
+
+    double x_upper = 0.0;
+    double y_upper = 0.0;
+    bool empty = true;
+    for (int i = 0; i < points.size(); i++) {
+        const double x = points[i].x();
+        const double y = points[i].y();
+        if (!qIsFinite(x) || !qIsFinite(y)) continue;
+
+        if (empty) {
+            x_lower = x_upper = x;
+            y_lower = y_upper = y;
+            empty = false;
+        }
+        x_lower = qMin(x_lower, x);
+        x_upper = qMax(x_upper, x);
+        y_lower = qMin(y_lower, y);
+        y_upper = qMax(y_upper, y);
+    }
+    if (empty) {
+        positions.clear();
+        return;
+    }
+
+    cell = qMax(cell_size, qMax(x_upper - x_lower, y_upper - y_lower) / max_cells_per_side);
+    nx = int((x_upper - x_lower) / cell) + 1;
+    ny = int((y_upper - y_lower) / cell) + 1;
+
+    QVector< int > point_cell(points.size(), -1);
+    cell_begin.fill(0, nx * ny + 1);
+    for (int i = 0; i < points.size(); i++) {
+        if (!qIsFinite(points[i].x()) || !qIsFinite(points[i].y())) continue;
+
+        const int cx = qMin(int((points[i].x() - x_lower) / cell), nx - 1);
+        const int cy = qMin(int((points[i].y() - y_lower) / cell), ny - 1);
+        point_cell[i] = cy * nx + cx;
+        cell_begin[point_cell[i] + 1]++;
+    }
+    for (int c = 0; c < nx * ny; c++) {
+        cell_begin[c + 1] += cell_begin[c];
+    }
+
+    QVector< int > next = cell_begin;
+    cell_points.resize(cell_begin.last());
+    for (int i = 0; i < points.size(); i++) {
+        if (point_cell[i] >= 0) {
+            cell_points[next[point_cell[i]]++] = i;
+        }
+    }
+}
+
+/*
+ *     Closest point within max_distance of the given one, or -1
+ *
+ *     Cells are visited in square rings around the cell of the query. A
+ *     point beyond ring r is at least r cells away, so the search stops
+ *     as soon as the best distance found is within that bound.
+ */
+int PointIndex::nearest(const QPointF &point, double max_distance) const
+{
+    if (isEmpty()) {
+        return -1;
+    }
+
+    const int cx = int(floor((point.x() - x_lower) / cell));
+    const int cy = int(floor((point.y() - y_lower) / cell));
+    const int max_ring = int(ceil(max_distance / cell)) + 1;
+
+    int best = -1;
+    double best_distance2 = max_distance * max_distance;
+
+    for (int r = 0; r <= max_ring; r++) {
+        if ((best >= 0) && ((r - 1) * cell) * ((r - 1) * cell) >= best_distance2) break;
+
+        const int x_first = qMax(cx - r, 0);
+        const int x_last = qMin(cx + r, nx - 1);
+        const int y_first = qMax(cy - r, 0);
+        const int y_last = qMin(cy + r, ny - 1);
+
+        for (int y = y_first; y <= y_last; y++) {
+            const bool edge_row = (y == cy - r) || (y == cy + r);
+            for (int x = x_first; x <= x_last; x++) {
+                // the inner cells were visited by the previous rings
+                if (!edge_row && (x != cx - r) && (x != cx + r)) continue;
+
+                const int c = y * nx + x;
+                for (int k = cell_begin[c]; k < cell_begin[c + 1]; k++) {
+                    const QPointF &p = positions[cell_points[k]];
+                    const double dx = p.x() - point.x();
+                    const double dy = p.y() - point.y();
+                    const double distance2 = dx * dx + dy * dy;
+                    if (distance2 <= best_distance2) {
+                        best_distance2 = distance2;
+                        best = cell_points[k];
+                    }
+                }
+            }
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,40 @@
+#ifndef POINTINDEX_H
+#define POINTINDEX_H
+
+#include <QVector>
+#include <QPointF>
+
+/*
+ *     Uniform grid over a point set for nearest point queries
+ *
+ *     Meant for points in pixel coordinates: with cells of a few pixels a
+ *     query near the cursor looks at a handful of cells whatever the number
+ *     of points. Points are stored sorted by cell, so the index is three
+ *     flat arrays. Non-finite points are left out.
+ */
+class PointIndex
+{
+public:
+    PointIndex();
+
+    void clear();
+
+    void build(const QVector< QPointF > &points, double cell_size);
+
+    int nearest(const QPointF &point, double max_distance) const;
+
+    bool isEmpty() const { return cell_points.isEmpty(); }
+
+private:
+    double x_lower;
+    double y_lower;
+    double cell;
+    int nx;
+    int ny;
+
+    QVector< int > cell_begin;
+    QVector< int > cell_points;
+    QVector< QPointF > positions;
+};
+
+#endif // POINTINDEX_H
@@ -0,0 +1,261 @@
+#include "pointpyramid.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <math.h>
+
+namespace {
+
+// depth of the finest level, 2^16 cells per side
+const int levels = 16;
+
+// share of the data extent added above the bounds for rows still to come
+const double growth_margin = 0.25;
+
+// below this many rows projecting every row is cheap enough
+const int min_rows = 65536;
+
+struct UpdateTask
+{
+    QSharedPointer< const PointPyramid > pyramid;
+    const QVector< QPointF > *points;
+};
+
+void runUpdateTask(UpdateTask &task)
+{
+    const int count = task.points->size();
+    if (!PointPyramid::needsUpdate(task.pyramid, count)) {
+        return;
+    }
+
+    PointPyramid *pyramid = task.pyramid ? new PointPyramid(*task.pyramid) : new PointPyramid();
+    if (task.pyramid) {
+        pyramid->extend(*task.points, count);
+    }
+    else {
+        pyramid->build(*task.points, count);
+    }
+    task.pyramid = QSharedPointer< const PointPyramid >(pyramid);
+}
+
+struct Entry
+{
+    quint32 code;
+    QPointF point;
+
+    bool operator<(const Entry &other) const { return code < other.code; }
+};
+
+quint32 spreadBits(quint32 v)
+{
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+int gridCell(double value, double lower, double upper)
+{
+    const double cell = (value - lower) / (upper - lower) * (1 << levels);
+    return qBound(0, int(cell), (1 << levels) - 1);
+}
+
+struct Descent
+{
+    const quint32 *codes;
+    const QPointF *points;
+    QRectF view;
+    double x_lower;
+    double y_lower;
+    double x_extent;
+    double y_extent;
+    int target;
+    QVector< QPointF > *out;
+};
+
+/*
+ *     Visit the tile (level, cx, cy) holding the sorted range [lo, hi)
+ */
+void descend(const Descent &d, int level, quint32 cx, quint32 cy, int lo, int hi)
+{
+    const double w = d.x_extent / double(quint32(1) << level);
+    const double h = d.y_extent / double(quint32(1) << level);
+    const QRectF tile(d.x_lower + cx * w, d.y_lower + cy * h, w, h);
+    if ((tile.right() < d.view.left()) || (tile.left() > d.view.right()) ||
+        (tile.bottom() < d.view.top()) || (tile.top() > d.view.bottom())) {
+        return;
+    }
+
+    if (level == d.target) {
+        d.out->append(d.points[lo]);
+        return;
+    }
+    if (level == levels) {
+        for (int i = lo; i < hi; i++) {
+            d.out->append(d.points[i]);
+        }
+        return;
+    }
+
+    const int shift = 2 * (levels - level - 1);
+    const quint64 prefix = (quint64(d.codes[lo]) >> (shift + 2)) << 2;
+    int begin = lo;
+    for (int q = 0; q < 4; q++) {
+        const quint64 end_code = (prefix + q + 1) << shift;
+        const int end = std::lower_bound(d.codes + begin, d.codes + hi, end_code,
+                                         [](quint32 code, quint64 bound) { return code < bound; }) - d.codes;
+        if (end > begin) {
+            descend(d, level + 1, 2 * cx + (q & 1), 2 * cy + (q >> 1), begin, end);
+        }
+        begin = end;
+    }
+}
+
+}
+
+PointPyramid::PointPyramid() :
+    x_lower(0.0), x_upper(1.0), y_lower(0.0), y_upper(1.0), row_cnt(0)
+{
+}
+
+/*
+ *     Index rows [0, count) of points; non-finite points are left out
+ */
+void PointPyramid::build(const QVector< QPointF > &points, int count)
+{
+    bool empty = true;
+    for (int i = 0; i < count; i++) {
+        const double x = points[i].x();
+        const double y = points[i].y();
+        if (!qIsFinite(x) || !qIsFinite(y)) continue;
+
+        if (empty) {
+            x_lower = x_upper = x;
+            y_lower = y_upper = y;
+            empty = false;
+        }
+        x_lower = qMin(x_lower, x);
+        x_upper = qMax(x_upper, x);
+        y_lower = qMin(y_lower, y);
+        y_upper = qMax(y_upper, y);
+    }
+    x_upper += (x_upper > x_lower) ? (x_upper - x_lower) * growth_margin : 1.0;
+    y_upper += (y_upper > y_lower) ? (y_upper - y_lower) * growth_margin : 1.0;
+
+    row_cnt = 0;
+    codes.clear();
+    sorted_points.clear();
+    extend(points, count);
+}
+
+/*
+ *     Add rows [size(), count) of points
+ *
+ *     The new rows are sorted on their own and merged with the sorted
+ *     ones. A row outside the bounds triggers a full build.
+ */
+void PointPyramid::extend(const QVector< QPointF > &points, int count)
+{
+    QVector< Entry > added;
+    added.reserve(count - row_cnt);
+    for (int i = row_cnt; i < count; i++) {
+        const double x = points[i].x();
+        const double y = points[i].y();
+        if (!qIsFinite(x) || !qIsFinite(y)) continue;
+
+        if ((x < x_lower) || (x >= x_upper) || (y < y_lower) || (y >= y_upper)) {
+            build(points, count);
+            return;
+        }
+        Entry entry;
+        entry.code = spreadBits(gridCell(x, x_lower, x_upper)) | (spreadBits(gridCell(y, y_lower, y_upper)) << 1);
+        entry.point = points[i];
+        added.append(entry);
+    }
+    std::sort(added.begin(), added.end());
+
+    QVector< quint32 > merged_codes(codes.size() + added.size());
+    QVector< QPointF > merged_points(codes.size() + added.size());
+    int i = 0;
+    int j = 0;
+    for (int k = 0; k < merged_codes.size(); k++) {
+        if ((j == added.size()) || ((i < codes.size()) && (codes[i] <= added[j].code))) {
+            merged_codes[k] = codes[i];
+            merged_points[k] = sorted_points[i++];
+        }
+        else {
+            merged_codes[k] = added[j].code;
+            merged_points[k] = added[j++].point;
+        }
+    }
+    codes = merged_codes;
+    sorted_points = merged_points;
+    row_cnt = count;
+}
+
+/*
+ *     Representatives of the tiles intersecting a view
+ *
+ *     The level used is the coarsest whose tiles are no larger than the
+ *     given cell (one pixel in data units). When even the finest tiles
+ *     are larger, every point of the visible tiles is returned.
+ */
+void PointPyramid::visiblePoints(const QRectF &view, double cell_width, double cell_height, QVector< QPointF > &out) const
+{
+    if (codes.isEmpty()) {
+        return;
+    }
+
+    Descent d;
+    d.codes = codes.constData();
+    d.points = sorted_points.constData();
+    d.view = view.normalized();
+    d.x_lower = x_lower;
+    d.y_lower = y_lower;
+    d.x_extent = x_upper - x_lower;
+    d.y_extent = y_upper - y_lower;
+    d.target = levels + 1;
+    for (int level = 0; level <= levels; level++) {
+        if ((d.x_extent / (1 << level) <= cell_width) && (d.y_extent / (1 << level) <= cell_height)) {
+            d.target = level;
+            break;
+        }
+    }
+    d.out = &out;
+
+    descend(d, 0, 0, 0, 0, codes.size());
+}
+
+/*
+ *     Whether a pyramid of count rows is worth (re)building: the set is
+ *     large and a quarter of it, or at least min_rows / 4 rows, is not
+ *     indexed yet
+ */
+bool PointPyramid::needsUpdate(const QSharedPointer< const PointPyramid > &pyramid, int count)
+{
+    const int built = pyramid ? pyramid->size() : 0;
+    return (count >= min_rows) && (count - built >= qMax(min_rows / 4, built / 4));
+}
+
+/*
+ *     Bring the pyramid of every point set up to date, one task per set;
+ *     pyramids that need no update are returned as they are
+ */
+QVector< QSharedPointer< const PointPyramid > > PointPyramid::updateAll(QVector< QSharedPointer< const PointPyramid > > pyramids,
+                                                                       QVector< QVector< QPointF > > point_sets)
+{
+    QVector< UpdateTask > tasks(point_sets.size());
+    for (int i = 0; i < tasks.size(); i++) {
+        tasks[i].pyramid = pyramids.value(i);
+        tasks[i].points = &point_sets.at(i);
+    }
+    QtConcurrent::blockingMap(tasks, runUpdateTask);
+
+    pyramids.resize(tasks.size());
+    for (int i = 0; i < tasks.size(); i++) {
+        pyramids[i] = tasks[i].pyramid;
+    }
+    return pyramids;
+}
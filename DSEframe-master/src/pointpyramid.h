@@ -0,0 +1,51 @@
+#ifndef POINTPYRAMID_H
+#define POINTPYRAMID_H
+
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include <QtGlobal>
+#include <QSharedPointer>
+
+/*
+ *     Level-of-detail quadtree over the rows of one method
+ *
+ *     The points are sorted by their Morton code on a 65536 x 65536 grid
+ *     over the data bounds, so every tile of every level is a contiguous
+ *     range of the sorted points: its first point is the tile's
+ *     representative and the length of the range its count. A view is
+ *     drawn from the representatives of the visible tiles of the level
+ *     whose tiles are about one pixel, found by descending only into
+ *     visible tiles. Rows added later are merged in without sorting the
+ *     earlier ones again; the bounds leave room for the data to grow.
+ */
+class PointPyramid
+{
+public:
+    PointPyramid();
+
+    void build(const QVector< QPointF > &points, int count);
+
+    void extend(const QVector< QPointF > &points, int count);
+
+    int size() const { return row_cnt; }
+
+    void visiblePoints(const QRectF &view, double cell_width, double cell_height, QVector< QPointF > &out) const;
+
+    static bool needsUpdate(const QSharedPointer< const PointPyramid > &pyramid, int count);
+
+    static QVector< QSharedPointer< const PointPyramid > > updateAll(QVector< QSharedPointer< const PointPyramid > > pyramids,
+                                                                    QVector< QVector< QPointF > > point_sets);
+
+private:
+    double x_lower;
+    double x_upper;
+    double y_lower;
+    double y_upper;
+    int row_cnt;
+
+    QVector< quint32 > codes;
+    QVector< QPointF > sorted_points;
+};
+
+#endif // POINTPYRAMID_H
@@ -0,0 +1,284 @@
+#include "pointraster.h"
+
+#include <QtConcurrent>
+
+#include <math.h>
+
+namespace {
+
+// rows per band, the unit of work of a thread
+const int band_rows = 32;
+
+// points binned per task
+const int chunk_points = 65536;
+
+struct Splat
+{
+    int x;
+    int y;
+    quint32 color;
+};
+
+struct Stamp
+{
+    int radius;
+    int size;
+    QVector< uchar > coverage;
+};
+
+struct Source
+{
+    const QPointF *points;
+    int count;
+    quint32 color;
+};
+
+struct Context
+{
+    uchar *bits;
+    int width;
+    int height;
+    int bytes_per_line;
+    double scale;
+    QPointF origin;
+    const Stamp *stamp;
+};
+
+struct BinTask
+{
+    const Context *context;
+    int band_cnt;
+    QVector< Source > sources;
+    QVector< int > band_counts;
+    Splat *out;
+    QVector< int > band_next;
+};
+
+struct BandTask
+{
+    const Context *context;
+    const Splat *splats;
+    int count;
+    int row_first;
+    int row_last;
+};
+
+// packed multiply of the four channels of x by a / 255
+inline quint32 byteMul(quint32 x, quint32 a)
+{
+    quint32 t = (x & 0xff00ff) * a;
+    t = (t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8;
+    t &= 0xff00ff;
+
+    x = ((x >> 8) & 0xff00ff) * a;
+    x = (x + ((x >> 8) & 0xff00ff) + 0x800080);
+    x &= 0xff00ff00;
+    return x | t;
+}
+
+/*
+ *     Coverage of a disc centered on the middle of pixel (radius, radius),
+ *     sampled 4 x 4 per pixel
+ */
+Stamp makeStamp(double diameter)
+{
+    Stamp stamp;
+    stamp.radius = int(ceil(diameter / 2.0));
+    stamp.size = 2 * stamp.radius + 1;
+    stamp.coverage.fill(0, stamp.size * stamp.size);
+
+    const double r2 = diameter * diameter / 4.0;
+    const double center = stamp.radius + 0.5;
+    for (int y = 0; y < stamp.size; y++) {
+        for (int x = 0; x < stamp.size; x++) {
+            int inside = 0;
+            for (int sy = 0; sy < 4; sy++) {
+                for (int sx = 0; sx < 4; sx++) {
+                    const double dx = x + (sx + 0.5) / 4.0 - center;
+                    const double dy = y + (sy + 0.5) / 4.0 - center;
+                    inside += (dx * dx + dy * dy <= r2) ? 1 : 0;
+                }
+            }
+            stamp.coverage[y * stamp.size + x] = uchar((inside * 255 + 8) / 16);
+        }
+    }
+    return stamp;
+}
+
+inline bool pixelOf(const Context &c, const QPointF &point, int *x, int *y)
+{
+    const double px = (point.x() - c.origin.x()) * c.scale;
+    const double py = (point.y() - c.origin.y()) * c.scale;
+    const int r = c.stamp->radius;
+    if (!(px >= -r) || !(py >= -r) || (px >= c.width + r) || (py >= c.height + r)) {
+        return false;
+    }
+    // the stamp is centered on the pixel the point falls in, as QPainter
+    // places the markers
+    *x = int(floor(px));
+    *y = int(floor(py));
+    return true;
+}
+
+/*
+ *     Count, then place, the splats of a chunk in every band they touch
+ */
+void runCountTask(BinTask &task)
+{
+    const Context &c = *task.context;
+    task.band_counts.fill(0, task.band_cnt);
+    const int r = c.stamp->radius;
+    for (int s = 0; s < task.sources.size(); s++) {
+        for (int i = 0; i < task.sources[s].count; i++) {
+            int x, y;
+            if (!pixelOf(c, task.sources[s].points[i], &x, &y)) continue;
+
+            const int first = qMax(y - r, 0) / band_rows;
+            const int last = qMin(y + r, c.height - 1) / band_rows;
+            for (int b = first; b <= last; b++) {
+                task.band_counts[b]++;
+            }
+        }
+    }
+}
+
+void runFillTask(BinTask &task)
+{
+    const Context &c = *task.context;
+    const int r = c.stamp->radius;
+    for (int s = 0; s < task.sources.size(); s++) {
+        for (int i = 0; i < task.sources[s].count; i++) {
+            int x, y;
+            if (!pixelOf(c, task.sources[s].points[i], &x, &y)) continue;
+
+            const int first = qMax(y - r, 0) / band_rows;
+            const int last = qMin(y + r, c.height - 1) / band_rows;
+            for (int b = first; b <= last; b++) {
+                Splat &splat = task.out[task.band_next[b]++];
+                splat.x = x;
+                splat.y = y;
+                splat.color = task.sources[s].color;
+            }
+        }
+    }
+}
+
+void runBandTask(BandTask &task)
+{
+    const Context &c = *task.context;
+    const Stamp &stamp = *c.stamp;
+    const int r = stamp.radius;
+
+    for (int k = 0; k < task.count; k++) {
+        const Splat &splat = task.splats[k];
+        const int y_first = qMax(splat.y - r, task.row_first);
+        const int y_last = qMin(splat.y + r, task.row_last);
+        const int x_first = qMax(splat.x - r, 0);
+        const int x_last = qMin(splat.x + r, c.width - 1);
+
+        for (int y = y_first; y <= y_last; y++) {
+            quint32 *line = reinterpret_cast< quint32 *>(c.bits + y * c.bytes_per_line);
+            const uchar *coverage = stamp.coverage.constData() + (y - splat.y + r) * stamp.size - splat.x + r;
+            for (int x = x_first; x <= x_last; x++) {
+                if (coverage[x] == 0) continue;
+
+                const quint32 src = (coverage[x] == 255) ? splat.color : byteMul(splat.color, coverage[x]);
+                line[x] = src + byteMul(line[x], 255 - (src >> 24));
+            }
+        }
+    }
+}
+
+}
+
+/*
+ *     Splat every stride-th point of the layers into the buffer
+ *
+ *     Point coordinates are mapped to buffer pixels as
+ *     (point - origin) * scale; diameter is in buffer pixels. Colors are
+ *     premultiplied ARGB.
+ */
+void PointRaster::splat(uchar *bits, int width, int height, int bytes_per_line, const QVector< Layer > &layers,
+                        double diameter, const QPointF &origin, double scale, int stride)
+{
+    if ((width <= 0) || (height <= 0)) {
+        return;
+    }
+
+    const Stamp stamp = makeStamp(diameter);
+    Context c;
+    c.bits = bits;
+    c.width = width;
+    c.height = height;
+    c.bytes_per_line = bytes_per_line;
+    c.scale = scale;
+    c.origin = origin;
+    c.stamp = &stamp;
+
+    // Chunks of consecutive points, in drawing order; strided layers are
+    // gathered first so a chunk reads contiguous points
+    QVector< QVector< QPointF > > strided(layers.size());
+    QVector< BinTask > chunks(1);
+    int chunk_size = 0;
+    for (int l = 0; l < layers.size(); l++) {
+        const QVector< QPointF > *points = layers[l].points;
+        if (stride > 1) {
+            strided[l].reserve(points->size() / stride + 1);
+            for (int i = 0; i < points->size(); i += stride) {
+                strided[l].append(points->at(i));
+            }
+            points = &strided[l];
+        }
+
+        for (int first = 0; first < points->size();) {
+            Source source;
+            source.points = points->constData() + first;
+            source.count = qMin(points->size() - first, chunk_points - chunk_size);
+            source.color = layers[l].color;
+            chunks.last().sources.append(source);
+
+            first += source.count;
+            chunk_size += source.count;
+            if (chunk_size == chunk_points) {
+                chunks.resize(chunks.size() + 1);
+                chunk_size = 0;
+            }
+        }
+    }
+
+    const int band_cnt = (height + band_rows - 1) / band_rows;
+    for (int k = 0; k < chunks.size(); k++) {
+        chunks[k].context = &c;
+        chunks[k].band_cnt = band_cnt;
+    }
+    QtConcurrent::blockingMap(chunks, runCountTask);
+
+    // Band-major, chunk-minor offsets keep the drawing order within a band
+    QVector< int > band_begin(band_cnt + 1, 0);
+    int total = 0;
+    for (int b = 0; b < band_cnt; b++) {
+        band_begin[b] = total;
+        for (int k = 0; k < chunks.size(); k++) {
+            chunks[k].band_next.resize(band_cnt);
+            chunks[k].band_next[b] = total;
+            total += chunks[k].band_counts[b];
+        }
+    }
+    band_begin[band_cnt] = total;
+
+    QVector< Splat > splats(total);
+    for (int k = 0; k < chunks.size(); k++) {
+        chunks[k].out = splats.data();
+    }
+    QtConcurrent::blockingMap(chunks, runFillTask);
+
+    QVector< BandTask > bands(band_cnt);
+    for (int b = 0; b < band_cnt; b++) {
+        bands[b].context = &c;
+        bands[b].splats = splats.constData() + band_begin[b];
+        bands[b].count = band_begin[b + 1] - band_begin[b];
+        bands[b].row_first = b * band_rows;
+        bands[b].row_last = qMin((b + 1) * band_rows, height) - 1;
+    }
+    QtConcurrent::blockingMap(bands, runBandTask);
+}
@@ -0,0 +1,30 @@
+#ifndef POINTRASTER_H
+#define POINTRASTER_H
+
+#include <QVector>
+#include <QPointF>
+#include <QtGlobal>
+
+/*
+ *     Software rasterizer for discs of one size
+ *
+ *     Points are splatted into a 32-bit premultiplied ARGB buffer with an
+ *     antialiased disc stamp and source-over blending. The buffer is cut
+ *     into bands of rows that are drawn on the thread pool; each band
+ *     blends its points in the order given, layer after layer, so the
+ *     result is the same as drawing them one by one.
+ */
+namespace PointRaster {
+
+struct Layer
+{
+    const QVector< QPointF > *points;
+    quint32 color;
+};
+
+void splat(uchar *bits, int width, int height, int bytes_per_line, const QVector< Layer > &layers,
+           double diameter, const QPointF &origin, double scale, int stride);
+
+}
+
+#endif // POINTRASTER_H
@@ -0,0 +1,25 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <QtGlobal>
+
+/*
+ *     SplitMix64 generator shared by the sampling tasks
+ *
+ *     Each call advances the state by a fixed step and returns a mix of it,
+ *     so a task seeded from (seed, chunk number) draws the same numbers on
+ *     any thread.
+ */
+namespace Random {
+
+inline quint64 splitMix64(quint64 &state)
+{
+    quint64 z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+}
+
+#endif // RANDOM_H
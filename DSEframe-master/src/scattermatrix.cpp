@@ -0,0 +1,549 @@
+#include "scattermatrix.h"
+#include "paretofront.h"
+#include "pointraster.h"
+
+#include <QPainter>
+#include <QMouseEvent>
+#include <QMenu>
+#include <QtConcurrent>
+
+namespace {
+
+// space around the matrix, in pixels
+const int matrix_margin = 8;
+
+// marker diameters of the rows and of the brushed rows
+const double row_diameter = 3.0;
+const double brushed_diameter = 4.0;
+
+const QColor brushed_color(220, 20, 60);
+
+}
+
+ScatterMatrix::ScatterMatrix(QWidget *parent) :
+    QWidget(parent, Qt::Window),
+    visible_version(0),
+    ranged_rows(0),
+    layout_version(0),
+    brush_i(-1),
+    brush_j(-1),
+    brushing(false),
+    selection_version(0)
+{
+    cell_watcher = new QFutureWatcher< QVector< CellJob > >(this);
+    connect(cell_watcher, SIGNAL(finished()), this, SLOT(cellsFinished()));
+
+    setMinimumSize(200, 200);
+}
+
+ScatterMatrix::~ScatterMatrix()
+{
+    cell_watcher->waitForFinished();
+}
+
+/*
+ *     Plot the rows of the visible groups
+ *
+ *     A copy of the store is kept for the render tasks, which is cheap as
+ *     its column blocks are shared. While the rows only grew, the column
+ *     ranges are grown by the new rows and the cells keep their images.
+ */
+void ScatterMatrix::setDesigns(const DesignStore &designs, const QVector< QColor > &colors, const QVector< bool > &visible)
+{
+    const bool appended = source && (designs.generation() == source->designs.generation()) &&
+                          (designs.rowCount() >= ranged_rows) && (visible == source->visible) && (colors == source->colors);
+    if (!appended) {
+        visible_version++;
+        ranged_rows = 0;
+        column_low.clear();
+        column_high.clear();
+    }
+
+    Source *data = new Source;
+    data->designs = designs;
+    data->colors = colors;
+    data->visible = visible;
+    source = QSharedPointer< const Source >(data);
+
+    designs.extendRanges(visible, ranged_rows, column_low, column_high);
+    ranged_rows = designs.rowCount();
+
+    updateAxes();
+    updateSelection();
+    render();
+    update();
+}
+
+void ScatterMatrix::setColumns(const QStringList &names)
+{
+    column_names = names;
+    brush_i = -1;
+    brush_j = -1;
+
+    updateAxes();
+    updateSelection();
+    render();
+    update();
+}
+
+/*
+ *     Resolve the chosen names to numeric columns of the store, over the
+ *     range of each among the visible rows with a 5% margin
+ */
+void ScatterMatrix::updateAxes()
+{
+    const QVector< int > last_columns = axis_columns;
+    axis_columns.clear();
+    axis_low.clear();
+    axis_high.clear();
+
+    for (int k = 0; source && (k < column_names.size()); k++) {
+        const int column = source->designs.columnIndex(column_names[k]);
+        if ((column == -1) || !source->designs.isNumeric(column)) continue;
+
+        double low = column_low.value(column, qInf());
+        double high = column_high.value(column, -qInf());
+        if (low > high) {
+            low = 0.0;
+            high = 1.0;
+        }
+        else if (low == high) {
+            low -= 0.5;
+            high += 0.5;
+        }
+
+        const double margin = (high - low) * 0.05;
+        axis_columns.append(column);
+        axis_low.append(low - margin);
+        axis_high.append(high + margin);
+    }
+
+    // Other columns start over; new ranges keep the old images on screen
+    // until theirs are rendered
+    if (axis_columns != last_columns) {
+        const View none = { 0.0, 0.0, 0.0, 0.0, QSize(), -1 };
+        Cell empty;
+        empty.view = none;
+        empty.rows = 0;
+        empty.overlay_version = -1;
+        cells.fill(empty, axis_columns.size() * axis_columns.size());
+        brush_i = -1;
+        brush_j = -1;
+        layout_version++;
+    }
+}
+
+/*
+ *     Mark the rows inside the brush in a bitset, one bit per row
+ *
+ *     The test is branch free over two columns, so a drag stays
+ *     interactive with millions of rows.
+ */
+void ScatterMatrix::updateSelection()
+{
+    selection_version++;
+    if (!source || (brush_i < 0)) {
+        selection.clear();
+        return;
+    }
+
+    const DesignStore &designs = source->designs;
+    const double x0 = brush_range.left();
+    const double x1 = brush_range.right();
+    const double y0 = brush_range.top();
+    const double y1 = brush_range.bottom();
+
+    QVector< quint64 > *bits = new QVector< quint64 >((designs.rowCount() + 63) / 64, 0);
+    for (int b = 0; b < designs.blockCount(); b++) {
+        const double *x_values = designs.columnBlock(axis_columns[brush_j], b).constData();
+        const double *y_values = designs.columnBlock(axis_columns[brush_i], b).constData();
+        const QVector< int > &groups = designs.groupBlock(b);
+        quint64 *words = bits->data() + b * DesignStore::block_rows / 64;
+
+        for (int i = 0; i < groups.size(); i++) {
+            const bool inside = (x_values[i] >= x0) & (x_values[i] <= x1) & (y_values[i] >= y0) & (y_values[i] <= y1);
+            words[i >> 6] |= quint64(inside && source->visible.value(groups[i])) << (i & 63);
+        }
+    }
+    selection = QSharedPointer< const QVector< quint64 > >(bits);
+}
+
+/*
+ *     Start rendering the cells whose images are out of date
+ *
+ *     A cell is rendered again from the first row when its view changed,
+ *     otherwise only the rows it has not shown yet are added to a copy of
+ *     its image. One batch runs at a time; the next one is started when it
+ *     finishes.
+ */
+void ScatterMatrix::render()
+{
+    if (cell_watcher->isRunning() || !source) {
+        return;
+    }
+
+    const int n = axis_columns.size();
+    const QSize size = cellRect(0, 0).size();
+    if ((n < 2) || size.isEmpty()) {
+        return;
+    }
+
+    const int row_cnt = source->designs.rowCount();
+    QVector< CellJob > jobs;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (i == j) continue;
+
+            const Cell &cell = cells[i * n + j];
+            CellJob job;
+            job.cell = i * n + j;
+            job.layout = layout_version;
+            job.version = 0;
+            job.overlay = false;
+            job.x_column = axis_columns[j];
+            job.y_column = axis_columns[i];
+            job.view.x_low = axis_low[j];
+            job.view.x_high = axis_high[j];
+            job.view.y_low = axis_low[i];
+            job.view.y_high = axis_high[i];
+            job.view.size = size;
+            job.view.visible_version = visible_version;
+            job.first_row = 0;
+            job.last_row = row_cnt;
+            job.source = source;
+
+            if (!(cell.view == job.view)) {
+                jobs.append(job);
+            }
+            else if (cell.rows < row_cnt) {
+                CellJob append = job;
+                append.first_row = cell.rows;
+                append.image = cell.base;
+                append.front = cell.front;
+                jobs.append(append);
+            }
+            if (selection && (cell.overlay_version != selection_version)) {
+                job.version = selection_version;
+                job.overlay = true;
+                job.selection = selection;
+                jobs.append(job);
+            }
+        }
+    }
+
+    if (!jobs.isEmpty()) {
+        cell_watcher->setFuture(QtConcurrent::run(ScatterMatrix::renderCells, jobs));
+    }
+}
+
+/*
+ *     Show the rendered images, then render what changed meanwhile
+ *
+ *     An image made for a view or a brush that changed since is still
+ *     newer than the one on screen, so it is shown until the next batch;
+ *     while rows keep streaming in, each batch would otherwise come too
+ *     late. Rows added to an image only apply to that image.
+ */
+void ScatterMatrix::cellsFinished()
+{
+    const QVector< CellJob > jobs = cell_watcher->result();
+    for (int k = 0; k < jobs.size(); k++) {
+        if (jobs[k].layout != layout_version) continue;
+
+        Cell &cell = cells[jobs[k].cell];
+        if (!jobs[k].overlay && ((jobs[k].first_row == 0) || ((cell.view == jobs[k].view) && (cell.rows == jobs[k].first_row)))) {
+            cell.base = jobs[k].image;
+            cell.view = jobs[k].view;
+            cell.rows = jobs[k].last_row;
+            cell.front = jobs[k].front;
+        }
+        else if (jobs[k].overlay && (jobs[k].version > cell.overlay_version)) {
+            cell.overlay = jobs[k].image;
+            cell.overlay_version = jobs[k].version;
+        }
+    }
+
+    render();
+    update();
+}
+
+QVector< ScatterMatrix::CellJob > ScatterMatrix::renderCells(QVector< CellJob > jobs)
+{
+    QtConcurrent::blockingMap(jobs, ScatterMatrix::renderCell);
+    return jobs;
+}
+
+/*
+ *     Render rows first_row..last_row of one cell, or only its brushed rows
+ *
+ *     Rows are visited from the last one and a pixel that already holds a
+ *     marker of them is skipped, so each pixel keeps the newest row and a
+ *     pass never splats more markers than the cell has pixels. Rows added
+ *     to an image are newer than the ones it shows, so they get a mask of
+ *     their own and are splatted over the image, taking the pixels of the
+ *     earlier rows as a full render would. The front of the rows is kept
+ *     with the image.
+ */
+void ScatterMatrix::renderCell(CellJob &job)
+{
+    const DesignStore &designs = job.source->designs;
+    const quint64 *brushed = job.overlay ? job.selection->constData() : 0;
+
+    const int width = job.view.size.width();
+    const int height = job.view.size.height();
+    const double x_scale = width / (job.view.x_high - job.view.x_low);
+    const double y_scale = height / (job.view.y_high - job.view.y_low);
+
+    if (job.first_row == 0) {
+        job.image = QImage(job.view.size, QImage::Format_ARGB32_Premultiplied);
+        job.image.fill(Qt::transparent);
+        job.front.clear();
+    }
+    QVector< quint64 > occupied((width * height + 63) / 64, 0);
+
+    QVector< QVector< QPointF > > pixels(job.overlay ? 1 : job.source->colors.size());
+    QVector< QPointF > points;
+
+    for (int b = designs.blockCount() - 1; b >= 0; b--) {
+        const int base = b * DesignStore::block_rows;
+        if (base >= job.last_row) continue;
+        if (base + DesignStore::block_rows <= job.first_row) break;
+
+        const double *x_values = designs.columnBlock(job.x_column, b).constData();
+        const double *y_values = designs.columnBlock(job.y_column, b).constData();
+        const int *groups = designs.groupBlock(b).constData();
+        const int first = qMax(job.first_row - base, 0);
+
+        for (int i = qMin(job.last_row - base, designs.groupBlock(b).size()) - 1; i >= first; i--) {
+            const int row = base + i;
+            if (brushed ? !((brushed[row >> 6] >> (row & 63)) & 1) : !job.source->visible.value(groups[i])) continue;
+
+            const double x = x_values[i];
+            const double y = y_values[i];
+            if (!qIsFinite(x) || !qIsFinite(y)) continue;
+
+            if (!job.overlay) {
+                points.append(QPointF(x, y));
+            }
+
+            const int px = int((x - job.view.x_low) * x_scale);
+            const int py = int((job.view.y_high - y) * y_scale);
+            if ((px < 0) || (py < 0) || (px >= width) || (py >= height)) continue;
+
+            const int bit = py * width + px;
+            if ((occupied[bit >> 6] >> (bit & 63)) & 1) continue;
+            occupied[bit >> 6] |= quint64(1) << (bit & 63);
+
+            pixels[job.overlay ? 0 : groups[i]].append(QPointF(px + 0.5, py + 0.5));
+        }
+    }
+
+    QVector< PointRaster::Layer > layers;
+    for (int g = 0; g < pixels.size(); g++) {
+        if (pixels[g].isEmpty()) continue;
+
+        PointRaster::Layer layer;
+        layer.points = &pixels[g];
+        layer.color = qPremultiply((job.overlay ? brushed_color : job.source->colors.value(g, Qt::black)).rgba());
+        layers.append(layer);
+    }
+    PointRaster::splat(job.image.bits(), width, height, job.image.bytesPerLine(), layers,
+                       job.overlay ? brushed_diameter : row_diameter, QPointF(0.0, 0.0), 1.0, 1);
+
+    if (!job.overlay) {
+        job.front = ParetoFront::merge(job.front, ParetoFront::build(points));
+    }
+}
+
+QRect ScatterMatrix::cellRect(int i, int j) const
+{
+    const int n = qMax(axis_columns.size(), 1);
+    const int side = (qMin(width(), height()) - 2 * matrix_margin) / n;
+    return QRect(matrix_margin + j * side, matrix_margin + i * side, side, side);
+}
+
+bool ScatterMatrix::cellAt(const QPoint &pos, int *i, int *j) const
+{
+    const int n = axis_columns.size();
+    for (int a = 0; a < n; a++) {
+        for (int b = 0; b < n; b++) {
+            if (cellRect(a, b).contains(pos)) {
+                *i = a;
+                *j = b;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ScatterMatrix::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    const int n = axis_columns.size();
+    if (n < 2) {
+        painter.drawText(rect(), Qt::AlignCenter, tr("Right-click to choose at least two numeric columns"));
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            const QRect cell_rect = cellRect(i, j);
+            const Cell &cell = cells[i * n + j];
+
+            if (i == j) {
+                painter.setPen(Qt::black);
+                painter.drawText(cell_rect, Qt::AlignCenter, source->designs.columnNames().at(axis_columns[i]));
+                painter.setPen(Qt::gray);
+                painter.drawText(cell_rect.adjusted(3, 0, 0, -2), Qt::AlignLeft | Qt::AlignBottom, QString::number(axis_low[i], 'g', 4));
+                painter.drawText(cell_rect.adjusted(0, 2, -3, 0), Qt::AlignRight | Qt::AlignTop, QString::number(axis_high[i], 'g', 4));
+            }
+            else {
+                // Images of another size are stretched until their rerender,
+                // and the front is drawn over the view of the image
+                if (!cell.base.isNull()) {
+                    painter.setOpacity(selection ? 0.3 : 1.0);
+                    painter.drawImage(cell_rect, cell.base);
+
+                    const double x_scale = cell_rect.width() / (cell.view.x_high - cell.view.x_low);
+                    const double y_scale = cell_rect.height() / (cell.view.y_high - cell.view.y_low);
+                    QPolygonF line;
+                    for (int k = 0; k < cell.front.size(); k++) {
+                        line << QPointF(cell_rect.left() + (cell.front[k].x() - cell.view.x_low) * x_scale,
+                                        cell_rect.top() + (cell.view.y_high - cell.front[k].y()) * y_scale);
+                    }
+                    painter.save();
+                    painter.setRenderHint(QPainter::Antialiasing);
+                    painter.setClipRect(cell_rect);
+                    painter.setPen(QPen(Qt::black, 1.5));
+                    painter.drawPolyline(line);
+                    painter.restore();
+                    painter.setOpacity(1.0);
+                }
+                if (selection && !cell.overlay.isNull()) {
+                    painter.drawImage(cell_rect, cell.overlay);
+                }
+            }
+
+            painter.setPen(Qt::lightGray);
+            painter.drawRect(cell_rect.adjusted(0, 0, -1, -1));
+        }
+    }
+
+    if (brush_i >= 0) {
+        const QRect cell_rect = cellRect(brush_i, brush_j);
+        const double x_scale = cell_rect.width() / (axis_high[brush_j] - axis_low[brush_j]);
+        const double y_scale = cell_rect.height() / (axis_high[brush_i] - axis_low[brush_i]);
+        const QRectF brush_rect(QPointF(cell_rect.left() + (brush_range.left() - axis_low[brush_j]) * x_scale,
+                                        cell_rect.top() + (axis_high[brush_i] - brush_range.bottom()) * y_scale),
+                                QPointF(cell_rect.left() + (brush_range.right() - axis_low[brush_j]) * x_scale,
+                                        cell_rect.top() + (axis_high[brush_i] - brush_range.top()) * y_scale));
+        painter.setPen(QPen(brushed_color, 1, Qt::DashLine));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawRect(brush_rect);
+    }
+}
+
+void ScatterMatrix::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    // Cached images keep being shown, stretched, until the new ones arrive
+    selection_version++;
+    render();
+}
+
+void ScatterMatrix::mousePressEvent(QMouseEvent *event)
+{
+    int i, j;
+    if ((event->button() != Qt::LeftButton) || !cellAt(event->pos(), &i, &j) || (i == j)) {
+        return;
+    }
+
+    brush_i = i;
+    brush_j = j;
+    brush_origin = event->pos();
+    brush_range = QRectF();
+    brushing = true;
+}
+
+/*
+ *     Brush the data range under the dragged rectangle
+ */
+void ScatterMatrix::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!brushing) {
+        return;
+    }
+
+    const QRect cell_rect = cellRect(brush_i, brush_j);
+    const QRect drag_rect = QRect(brush_origin, event->pos()).normalized() & cell_rect;
+    const double x_scale = (axis_high[brush_j] - axis_low[brush_j]) / cell_rect.width();
+    const double y_scale = (axis_high[brush_i] - axis_low[brush_i]) / cell_rect.height();
+
+    brush_range = QRectF(QPointF(axis_low[brush_j] + (drag_rect.left() - cell_rect.left()) * x_scale,
+                                 axis_high[brush_i] - (drag_rect.bottom() + 1 - cell_rect.top()) * y_scale),
+                         QPointF(axis_low[brush_j] + (drag_rect.right() + 1 - cell_rect.left()) * x_scale,
+                                 axis_high[brush_i] - (drag_rect.top() - cell_rect.top()) * y_scale));
+
+    updateSelection();
+    render();
+    update();
+}
+
+/*
+ *     A click without a drag clears the brush
+ */
+void ScatterMatrix::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (!brushing) {
+        return;
+    }
+    brushing = false;
+
+    if ((event->pos() - brush_origin).manhattanLength() < 3) {
+        brush_i = -1;
+        brush_j = -1;
+        updateSelection();
+        update();
+    }
+}
+
+/*
+ *     Choose the columns of the matrix among the numeric ones
+ */
+void ScatterMatrix::contextMenuEvent(QContextMenuEvent *event)
+{
+    if (!source) {
+        return;
+    }
+
+    QMenu menu(this);
+    const QStringList &names = source->designs.columnNames();
+    for (int c = 0; c < names.size(); c++) {
+        if (!source->designs.isNumeric(c)) continue;
+
+        QAction *action = menu.addAction(names[c]);
+        action->setCheckable(true);
+        action->setChecked(column_names.contains(names[c]));
+    }
+
+    QAction *action = menu.exec(event->globalPos());
+    if (!action) {
+        return;
+    }
+
+    QStringList chosen = column_names;
+    if (action->isChecked()) {
+        chosen.append(action->text());
+    }
+    else {
+        chosen.removeAll(action->text());
+    }
+    setColumns(chosen);
+    emit columnsChanged(chosen);
+}
@@ -0,0 +1,146 @@
+#ifndef SCATTERMATRIX_H
+#define SCATTERMATRIX_H
+
+#include <QWidget>
+#include <QImage>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+
+#include "designstore.h"
+
+/*
+ *     Scatterplot matrix of chosen columns of the design store
+ *
+ *     Cell (i, j) plots column j against column i over the rows of the
+ *     visible groups, at most one marker per pixel, with the 2-D front of
+ *     those rows; the diagonal names the columns. Cells are rendered into
+ *     images on the thread pool and cached until the range of one of
+ *     their axes, the visible groups or the cell size change; rows
+ *     appended meanwhile are rendered over the cached image, and the
+ *     ranges are grown by the new rows only. Dragging a rectangle in a
+ *     cell brushes the rows inside it, and only the brushed rows are
+ *     rendered again to highlight them in every cell.
+ */
+class ScatterMatrix : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ScatterMatrix(QWidget *parent = 0);
+    ~ScatterMatrix();
+
+    void setDesigns(const DesignStore &designs, const QVector< QColor > &colors, const QVector< bool > &visible);
+
+    void setColumns(const QStringList &names);
+
+    const QStringList &columns() const { return column_names; }
+
+signals:
+    void columnsChanged(const QStringList &names);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+    void resizeEvent(QResizeEvent *event) override;
+
+    void mousePressEvent(QMouseEvent *event) override;
+
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+    void contextMenuEvent(QContextMenuEvent *event) override;
+
+private slots:
+    void cellsFinished();
+
+private:
+    struct Source
+    {
+        DesignStore designs;
+        QVector< QColor > colors;
+        QVector< bool > visible;
+    };
+
+    struct View
+    {
+        double x_low;
+        double x_high;
+        double y_low;
+        double y_high;
+        QSize size;
+        int visible_version;
+
+        bool operator==(const View &other) const
+        {
+            return (x_low == other.x_low) && (x_high == other.x_high) && (y_low == other.y_low) &&
+                   (y_high == other.y_high) && (size == other.size) && (visible_version == other.visible_version);
+        }
+    };
+
+    struct Cell
+    {
+        QImage base;
+        View view;
+        int rows;
+        QVector< QPointF > front;
+
+        QImage overlay;
+        int overlay_version;
+    };
+
+    struct CellJob
+    {
+        int cell;
+        int layout;
+        int version;
+        bool overlay;
+        int x_column;
+        int y_column;
+        View view;
+        int first_row;
+        int last_row;
+        QSharedPointer< const Source > source;
+        QSharedPointer< const QVector< quint64 > > selection;
+        QImage image;
+        QVector< QPointF > front;
+    };
+
+    static QVector< CellJob > renderCells(QVector< CellJob > jobs);
+
+    static void renderCell(CellJob &job);
+
+    void updateAxes();
+
+    void updateSelection();
+
+    void render();
+
+    QRect cellRect(int i, int j) const;
+
+    bool cellAt(const QPoint &pos, int *i, int *j) const;
+
+    QStringList column_names;
+    QSharedPointer< const Source > source;
+    int visible_version;
+    int ranged_rows;
+    QVector< double > column_low;
+    QVector< double > column_high;
+    QVector< int > axis_columns;
+    QVector< double > axis_low;
+    QVector< double > axis_high;
+
+    QVector< Cell > cells;
+    int layout_version;
+    QFutureWatcher< QVector< CellJob > > *cell_watcher;
+
+    int brush_i;
+    int brush_j;
+    QPoint brush_origin;
+    bool brushing;
+    QRectF brush_range;
+    QSharedPointer< const QVector< quint64 > > selection;
+    int selection_version;
+};
+
+#endif // SCATTERMATRIX_H
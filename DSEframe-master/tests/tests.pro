@@ -0,0 +1,35 @@
+#-------------------------------------------------
+#
+# Known-answer tests of the algorithms in ../src
+#
+# qmake && make && ./tst_algorithms
+#
+#-------------------------------------------------
+
+QT       += core concurrent testlib
+QT       -= gui
+
+TARGET = tst_algorithms
+CONFIG += console testcase
+CONFIG -= app_bundle
+TEMPLATE = app
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../src
+
+SOURCES += \
+        tst_algorithms.cpp \
+    ../src/paretofront.cpp \
+    ../src/hypervolume.cpp \
+    ../src/pointindex.cpp \
+    ../src/pointpyramid.cpp \
+    ../src/pointraster.cpp
+
+HEADERS += \
+    ../src/paretofront.h \
+    ../src/hypervolume.h \
+    ../src/pointindex.h \
+    ../src/pointpyramid.h \
+    ../src/pointraster.h \
+    ../src/random.h
@@ -0,0 +1,376 @@
+#include <QtTest>
+
+#include "paretofront.h"
+#include "hypervolume.h"
+#include "pointindex.h"
+#include "pointpyramid.h"
+#include "pointraster.h"
+#include "random.h"
+
+#include <math.h>
+
+/*
+ *     Known-answer checks of the front, hypervolume and plotting algorithms
+ *
+ *     Each fast path is compared with a value worked out by hand or with a
+ *     slow path that is obviously right: sequential front insertion,
+ *     inclusion-exclusion over the boxes of the points, a linear nearest
+ *     point search and splatting the points a few at a time. Random inputs
+ *     come from fixed seeds, so a failure can be replayed.
+ */
+class TestAlgorithms : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parallelFrontsMatchSequential();
+    void hypervolumeKnownAnswers();
+    void hypervolumeMatchesInclusionExclusion();
+    void incrementalHypervolumeMatchesBatch();
+    void pickIndexMatchesBruteForce();
+    void pyramidCoversEveryPoint();
+    void rasterMatchesSplattingInParts();
+};
+
+namespace {
+
+double uniform(quint64 &state)
+{
+    return (Random::splitMix64(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Small integer coordinates, so that many points tie
+QVector< QPointF > randomPoints(quint64 &state, int count, int range)
+{
+    QVector< QPointF > points(count);
+    for (int i = 0; i < count; i++) {
+        points[i] = QPointF(int(uniform(state) * range), int(uniform(state) * range));
+    }
+    return points;
+}
+
+QVector< double > randomFlatPoints(quint64 &state, int count, int dimension)
+{
+    QVector< double > points(count * dimension);
+    for (int i = 0; i < points.size(); i++) {
+        points[i] = uniform(state);
+    }
+    return points;
+}
+
+/*
+ *     Volume of the union of the boxes between each point and the
+ *     reference, summing the intersections of every subset with
+ *     alternating signs
+ */
+double inclusionExclusion(const QVector< double > &points, int dimension, const QVector< double > &reference)
+{
+    const int n = points.size() / dimension;
+    double volume = 0.0;
+    for (int subset = 1; subset < (1 << n); subset++) {
+        double box = 1.0;
+        int members = 0;
+        for (int d = 0; d < dimension; d++) {
+            double corner = -HUGE_VAL;
+            for (int i = 0; i < n; i++) {
+                if (subset & (1 << i)) {
+                    corner = qMax(corner, points[i * dimension + d]);
+                }
+            }
+            box *= qMax(reference[d] - corner, 0.0);
+        }
+        for (int i = 0; i < n; i++) {
+            members += (subset >> i) & 1;
+        }
+        volume += (members % 2) ? box : -box;
+    }
+    return volume;
+}
+
+bool samePoints(const QVector< QPointF > &a, const QVector< QPointF > &b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (int i = 0; i < a.size(); i++) {
+        if ((a[i].x() != b[i].x()) || (a[i].y() != b[i].y())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+/*
+ *     Fronts built per method on the thread pool and merged by reduction
+ *     equal the fronts of inserting every point in turn
+ */
+void TestAlgorithms::parallelFrontsMatchSequential()
+{
+    quint64 state = 26;
+    QVector< QVector< QPointF > > point_sets(40);
+    for (int g = 0; g < point_sets.size(); g++) {
+        point_sets[g] = randomPoints(state, 1 + g * 50, 200);
+    }
+
+    const QVector< QVector< QPointF > > fronts = ParetoFront::buildAll(point_sets);
+    QCOMPARE(fronts.size(), point_sets.size());
+
+    QVector< QPointF > global;
+    GlobalFront inserted;
+    QVector< int > owners;
+    for (int g = 0; g < point_sets.size(); g++) {
+        QVector< QPointF > front;
+        for (int i = 0; i < point_sets[g].size(); i++) {
+            ParetoFront::insertPoint(front, point_sets[g][i]);
+            ParetoFront::insertPoint(global, point_sets[g][i]);
+        }
+        QVERIFY(samePoints(fronts[g], front));
+        QVERIFY(samePoints(ParetoFront::build(point_sets[g]), front));
+
+        for (int i = 0; i < front.size(); i++) {
+            inserted.insert(front[i], g);
+        }
+        owners.append(g);
+    }
+
+    QVERIFY(samePoints(ParetoFront::mergeAll(fronts), global));
+
+    GlobalFront built;
+    built.build(fronts, owners);
+    QVERIFY(samePoints(built.points(), global));
+    QVERIFY(samePoints(inserted.points(), global));
+    for (int g = 0; g < point_sets.size(); g++) {
+        QCOMPARE(built.ownedCount(g), inserted.ownedCount(g));
+    }
+}
+
+void TestAlgorithms::hypervolumeKnownAnswers()
+{
+    // A staircase of three unit steps under (4, 4)
+    QVector< QPointF > staircase;
+    staircase << QPointF(1, 3) << QPointF(2, 2) << QPointF(3, 1);
+    QCOMPARE(Hypervolume::compute(staircase, QPointF(4, 4)), 6.0);
+
+    // A point on the reference adds nothing, a dominated one neither
+    staircase << QPointF(4, 0) << QPointF(3, 3);
+    QCOMPARE(Hypervolume::compute(staircase, QPointF(4, 4)), 6.0);
+
+    // Two 2 x 1 x 1 boxes overlapping in a unit cube
+    QVector< double > boxes;
+    boxes << 0 << 1 << 1 << 1 << 0 << 1;
+    QVector< double > reference_3d;
+    reference_3d << 2 << 2 << 2;
+    QCOMPARE(Hypervolume::compute(boxes, 3, reference_3d), 3.0);
+
+    // One point spans the whole box in 4-D
+    QVector< double > corner(4, 0.0);
+    QVector< double > reference_4d;
+    reference_4d << 1 << 2 << 3 << 4;
+    QCOMPARE(Hypervolume::compute(corner, 4, reference_4d), 24.0);
+}
+
+void TestAlgorithms::hypervolumeMatchesInclusionExclusion()
+{
+    quint64 state = 30;
+    for (int dimension = 2; dimension <= 5; dimension++) {
+        const QVector< double > reference(dimension, 1.0);
+        for (int trial = 0; trial < 20; trial++) {
+            const QVector< double > points = randomFlatPoints(state, 1 + trial % 10, dimension);
+            const double expected = inclusionExclusion(points, dimension, reference);
+            QVERIFY(qAbs(Hypervolume::compute(points, dimension, reference) - expected) <= 1e-12);
+        }
+    }
+}
+
+/*
+ *     Adding the exclusive volume of each point gives the hypervolume of
+ *     all the points seen so far
+ */
+void TestAlgorithms::incrementalHypervolumeMatchesBatch()
+{
+    quint64 state = 27;
+    for (int dimension = 2; dimension <= 4; dimension++) {
+        const QVector< double > reference(dimension, 1.0);
+        const QVector< double > points = randomFlatPoints(state, 300, dimension);
+
+        IncrementalHypervolume incremental(dimension);
+        incremental.reset(reference);
+        for (int i = 0; i < points.size() / dimension; i++) {
+            incremental.insert(points.constData() + i * dimension);
+            if ((i % 25) == 0) {
+                const double batch = Hypervolume::compute(points.mid(0, (i + 1) * dimension), dimension, reference);
+                QVERIFY(qAbs(incremental.value() - batch) <= 1e-12);
+            }
+        }
+        QVERIFY(qAbs(incremental.value() - Hypervolume::compute(points, dimension, reference)) <= 1e-12);
+    }
+
+    // The 2-D staircase with ties
+    const QVector< QPointF > points = randomPoints(state, 500, 50);
+    IncrementalHypervolume incremental;
+    incremental.reset(QPointF(50, 50));
+    for (int i = 0; i < points.size(); i++) {
+        incremental.insert(points[i]);
+    }
+    QCOMPARE(incremental.value(), Hypervolume::compute(points, QPointF(50, 50)));
+}
+
+/*
+ *     The grid finds a point as near as the nearest of all points, and
+ *     nothing when no point is within the distance
+ */
+void TestAlgorithms::pickIndexMatchesBruteForce()
+{
+    quint64 state = 33;
+    QVector< QPointF > points(3000);
+    for (int i = 0; i < points.size(); i++) {
+        points[i] = QPointF(uniform(state) * 800.0, uniform(state) * 600.0);
+    }
+    points[17] = QPointF(qQNaN(), 10.0);
+
+    PointIndex index;
+    index.build(points, 4.0);
+
+    const double max_distance = 8.0;
+    for (int q = 0; q < 2000; q++) {
+        const QPointF query(uniform(state) * 840.0 - 20.0, uniform(state) * 640.0 - 20.0);
+
+        double best = max_distance * max_distance;
+        bool found = false;
+        for (int i = 0; i < points.size(); i++) {
+            const double dx = points[i].x() - query.x();
+            const double dy = points[i].y() - query.y();
+            if (dx * dx + dy * dy <= best) {
+                best = dx * dx + dy * dy;
+                found = true;
+            }
+        }
+
+        const int nearest = index.nearest(query, max_distance);
+        QCOMPARE(nearest >= 0, found);
+        if (found) {
+            const double dx = points[nearest].x() - query.x();
+            const double dy = points[nearest].y() - query.y();
+            QCOMPARE(dx * dx + dy * dy, best);
+        }
+    }
+}
+
+/*
+ *     Every point in a view lies in a tile about one cell wide whose
+ *     representative is drawn, so drawing the representatives leaves no
+ *     pixel of a full splat more than a cell away from a marker
+ */
+void TestAlgorithms::pyramidCoversEveryPoint()
+{
+    quint64 state = 45;
+    QVector< QPointF > points(100000);
+    for (int i = 0; i < points.size(); i++) {
+        const double t = uniform(state);
+        points[i] = QPointF(t * 100.0 + uniform(state) * 5.0, 100.0 / (1.0 + t * 10.0) + uniform(state) * 5.0);
+    }
+
+    // Built at once, and grown from half of the rows
+    PointPyramid built;
+    built.build(points, points.size());
+    PointPyramid grown;
+    grown.build(points, points.size() / 2);
+    grown.extend(points, points.size());
+    QCOMPARE(built.size(), points.size());
+    QCOMPARE(grown.size(), points.size());
+
+    QVector< QRectF > views;
+    views << QRectF(0, 0, 110, 110) << QRectF(20, 10, 30, 20) << QRectF(90, 0, 15, 10);
+    for (int v = 0; v < views.size(); v++) {
+        const QRectF view = views[v];
+        const double cell_width = view.width() / 400.0;
+        const double cell_height = view.height() / 300.0;
+        const int columns = int(ceil(view.width() / cell_width)) + 1;
+        const int rows = int(ceil(view.height() / cell_height)) + 1;
+
+        for (int p = 0; p < 2; p++) {
+            QVector< QPointF > shown;
+            (p ? grown : built).visiblePoints(view, cell_width, cell_height, shown);
+            QVERIFY(!shown.isEmpty());
+            QVERIFY(shown.size() <= points.size());
+
+            // The representatives binned by cell of the view
+            QVector< QVector< QPointF > > bins(columns * rows);
+            for (int i = 0; i < shown.size(); i++) {
+                const int cx = int(floor((shown[i].x() - view.left()) / cell_width));
+                const int cy = int(floor((shown[i].y() - view.top()) / cell_height));
+                if ((cx >= -1) && (cy >= -1) && (cx <= columns) && (cy <= rows)) {
+                    bins[qBound(0, cy, rows - 1) * columns + qBound(0, cx, columns - 1)].append(shown[i]);
+                }
+            }
+
+            for (int i = 0; i < points.size(); i++) {
+                if (!view.contains(points[i])) continue;
+
+                const int cx = int(floor((points[i].x() - view.left()) / cell_width));
+                const int cy = int(floor((points[i].y() - view.top()) / cell_height));
+                bool covered = false;
+                for (int y = qMax(cy - 1, 0); !covered && (y <= qMin(cy + 1, rows - 1)); y++) {
+                    for (int x = qMax(cx - 1, 0); !covered && (x <= qMin(cx + 1, columns - 1)); x++) {
+                        const QVector< QPointF > &bin = bins[y * columns + x];
+                        for (int k = 0; !covered && (k < bin.size()); k++) {
+                            covered = (qAbs(bin[k].x() - points[i].x()) <= cell_width * (1.0 + 1e-9)) &&
+                                      (qAbs(bin[k].y() - points[i].y()) <= cell_height * (1.0 + 1e-9));
+                        }
+                    }
+                }
+                QVERIFY(covered);
+            }
+        }
+    }
+}
+
+/*
+ *     One splat spread over chunks and bands on the thread pool blends
+ *     like splatting the same layers a thousand points at a time
+ */
+void TestAlgorithms::rasterMatchesSplattingInParts()
+{
+    const int width = 320;
+    const int height = 240;
+    quint64 state = 46;
+
+    QVector< QVector< QPointF > > point_sets(3);
+    QVector< PointRaster::Layer > layers;
+    const quint32 colors[3] = { 0x80800000u, 0xc000c000u, 0x40000040u };
+    for (int l = 0; l < point_sets.size(); l++) {
+        point_sets[l].resize(l ? 20000 : 70000);
+        for (int i = 0; i < point_sets[l].size(); i++) {
+            point_sets[l][i] = QPointF(uniform(state) * (width + 20) - 10, uniform(state) * (height + 20) - 10);
+        }
+
+        PointRaster::Layer layer;
+        layer.points = &point_sets[l];
+        layer.color = colors[l];
+        layers.append(layer);
+    }
+
+    for (int stride = 1; stride <= 3; stride += 2) {
+        QVector< quint32 > whole(width * height, 0);
+        PointRaster::splat(reinterpret_cast< uchar *>(whole.data()), width, height, width * 4, layers, 5.0, QPointF(0, 0), 1.0, stride);
+
+        QVector< quint32 > parts(width * height, 0);
+        for (int l = 0; l < point_sets.size(); l++) {
+            for (int first = 0; first < point_sets[l].size(); first += 1000 * stride) {
+                QVector< QPointF > part = point_sets[l].mid(first, 1000 * stride);
+                QVector< PointRaster::Layer > part_layers(1);
+                part_layers[0].points = &part;
+                part_layers[0].color = colors[l];
+                PointRaster::splat(reinterpret_cast< uchar *>(parts.data()), width, height, width * 4, part_layers, 5.0, QPointF(0, 0), 1.0, stride);
+            }
+        }
+
+        QVERIFY(whole == parts);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestAlgorithms)
+
+#include "tst_algorithms.moc"